@@ -13,17 +13,21 @@
 
 #include "SimpleSurface.h"
 
+#include "SimpleSurfaceMeshIdentity.h"
+
 #define LOCTEXT_NAMESPACE "FSimpleSurfaceModule"
 
 void FSimpleSurfaceModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FSimpleSurfaceMeshIdentity::Get().RegisterBuiltInProviders();
 }
 
 void FSimpleSurfaceModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FSimpleSurfaceMeshIdentity::Get().Reset();
 }
 
 #undef LOCTEXT_NAMESPACE
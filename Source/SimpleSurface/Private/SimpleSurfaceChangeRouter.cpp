@@ -0,0 +1,199 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceChangeRouter.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "Components/ActorComponent.h"
+#include "Components/MeshComponent.h"
+#include "GameFramework/Actor.h"
+#include "Misc/CoreDelegates.h"
+
+FSimpleSurfaceChangeRouter& FSimpleSurfaceChangeRouter::Get()
+{
+	static FSimpleSurfaceChangeRouter Router;
+	return Router;
+}
+
+void FSimpleSurfaceChangeRouter::AddListener(USimpleSurfaceComponent& Listener)
+{
+	const AActor* Owner = Listener.GetOwner();
+	if (!Owner)
+	{
+		return;
+	}
+
+	// A listener moved to another actor stops listening to the first.
+	if (const auto ListenedOwner = OwnersByListener.Find(&Listener); ListenedOwner && *ListenedOwner != Owner)
+	{
+		RemoveListener(Listener);
+	}
+
+	if (ListenersByOwner.IsEmpty())
+	{
+		BindDelegates();
+	}
+
+	ListenersByOwner.FindOrAdd(Owner).AddUnique(&Listener);
+	OwnersByListener.Add(&Listener, Owner);
+}
+
+void FSimpleSurfaceChangeRouter::RemoveListener(USimpleSurfaceComponent& Listener)
+{
+	// The listener may have lost its owner since it was added, e.g. while being destroyed.
+	TObjectKey<AActor> Owner;
+	if (!OwnersByListener.RemoveAndCopyValue(&Listener, Owner))
+	{
+		return;
+	}
+
+	if (auto Listeners = ListenersByOwner.Find(Owner))
+	{
+		Listeners->RemoveSwap(&Listener);
+		if (Listeners->IsEmpty())
+		{
+			ListenersByOwner.Remove(Owner);
+			DirtyOwners.Remove(Owner);
+		}
+	}
+
+	if (ListenersByOwner.IsEmpty())
+	{
+		UnbindDelegates();
+	}
+}
+
+void FSimpleSurfaceChangeRouter::BindDelegates()
+{
+	// Material overrides, static mesh changes and dynamic mesh updates all dirty the component's render state.
+	RenderStateDirtyHandle = UActorComponent::MarkRenderStateDirtyEvent.AddRaw(this, &FSimpleSurfaceChangeRouter::HandleRenderStateDirty);
+
+	// Primitive components create and destroy their physics state as they're registered and unregistered.
+	CreatePhysicsHandle = UActorComponent::GlobalCreatePhysicsDelegate.AddRaw(this, &FSimpleSurfaceChangeRouter::HandlePhysicsStateChanged);
+	DestroyPhysicsHandle = UActorComponent::GlobalDestroyPhysicsDelegate.AddRaw(this, &FSimpleSurfaceChangeRouter::HandlePhysicsStateChanged);
+
+	// Render state dirty notifications are handled at the end of the frame; see the class comment.
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FSimpleSurfaceChangeRouter::HandleEndFrame);
+
+#if WITH_EDITOR
+	// Adding and removing components in the editor modifies the actor; editing a mesh or material slot in the details panel
+	// changes a property.
+	ObjectModifiedHandle = FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &FSimpleSurfaceChangeRouter::HandleObjectModified);
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FSimpleSurfaceChangeRouter::HandleObjectPropertyChanged);
+#endif
+}
+
+void FSimpleSurfaceChangeRouter::UnbindDelegates()
+{
+	UActorComponent::MarkRenderStateDirtyEvent.Remove(RenderStateDirtyHandle);
+	UActorComponent::GlobalCreatePhysicsDelegate.Remove(CreatePhysicsHandle);
+	UActorComponent::GlobalDestroyPhysicsDelegate.Remove(DestroyPhysicsHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+#endif
+}
+
+const AActor* FSimpleSurfaceChangeRouter::GetOwnerOf(const UObject* Object)
+{
+	if (const auto MeshComponent = Cast<UMeshComponent>(Object))
+	{
+		return MeshComponent->GetOwner();
+	}
+	return Cast<AActor>(Object);
+}
+
+void FSimpleSurfaceChangeRouter::NotifyOwnerOf(const UObject* Object)
+{
+	const AActor* Owner = GetOwnerOf(Object);
+	if (const auto Listeners = Owner ? ListenersByOwner.Find(Owner) : nullptr)
+	{
+		for (const auto& Listener : *Listeners)
+		{
+			if (auto SafeListener = Listener.Get())
+			{
+				SafeListener->NotifyMeshComponentsChanged();
+			}
+		}
+	}
+}
+
+void FSimpleSurfaceChangeRouter::HandleRenderStateDirty(UActorComponent& Component)
+{
+	const AActor* Owner = GetOwnerOf(&Component);
+	const auto Listeners = Owner ? ListenersByOwner.Find(Owner) : nullptr;
+	if (!Listeners)
+	{
+		return;
+	}
+
+	// Ignore the render state a listener dirties itself, assigning materials or writing custom data.
+	for (const auto& Listener : *Listeners)
+	{
+		const auto SafeListener = Listener.Get();
+		if (SafeListener && SafeListener->IsApplyingSurface())
+		{
+			return;
+		}
+	}
+
+	DirtyOwners.Add(Owner);
+}
+
+void FSimpleSurfaceChangeRouter::HandleEndFrame()
+{
+	if (DirtyOwners.IsEmpty())
+	{
+		return;
+	}
+
+	// Polling only dirties render state while applying, which is ignored, so no owner is added while these are checked.
+	const auto OwnersToCheck = MoveTemp(DirtyOwners);
+	DirtyOwners.Reset();
+	for (const auto& Owner : OwnersToCheck)
+	{
+		const auto Listeners = ListenersByOwner.Find(Owner);
+		if (!Listeners)
+		{
+			continue;
+		}
+
+		for (const auto& Listener : *Listeners)
+		{
+			auto SafeListener = Listener.Get();
+			if (SafeListener && SafeListener->IsRegistered() && SafeListener->IsActive())
+			{
+				SafeListener->PollForChanges();
+			}
+		}
+	}
+}
+
+void FSimpleSurfaceChangeRouter::HandlePhysicsStateChanged(UActorComponent* Component)
+{
+	NotifyOwnerOf(Component);
+}
+
+#if WITH_EDITOR
+void FSimpleSurfaceChangeRouter::HandleObjectModified(UObject* Object)
+{
+	NotifyOwnerOf(Object);
+}
+
+void FSimpleSurfaceChangeRouter::HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	NotifyOwnerOf(Object);
+}
+#endif
@@ -0,0 +1,90 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UActorComponent;
+class USimpleSurfaceComponent;
+struct FPropertyChangedEvent;
+
+/**
+ * Routes engine-wide component, mesh and material change notifications to the event-driven SimpleSurfaceComponents
+ * on the affected actor.
+ *
+ * The engine's notifications are global, so rather than having every SimpleSurfaceComponent subscribe (and filter
+ * every notification), this binds to each notification once and looks up listeners by owning actor.
+ *
+ * A component whose render state is already dirty raises no further notifications until it's recreated, so rather
+ * than re-applying on the first one, listeners on actors whose components were dirtied are checked once at the end of
+ * the frame, after every change made in it.  Idle actors cost nothing.
+ *
+ * Registering a mesh component without collision raises no notification; @see USimpleSurfaceComponent::NotifyMeshComponentsChanged
+ */
+class FSimpleSurfaceChangeRouter
+{
+public:
+	static FSimpleSurfaceChangeRouter& Get();
+
+	void AddListener(USimpleSurfaceComponent& Listener);
+	void RemoveListener(USimpleSurfaceComponent& Listener);
+
+private:
+	void BindDelegates();
+	void UnbindDelegates();
+
+	using FListeners = TArray<TWeakObjectPtr<USimpleSurfaceComponent>, TInlineAllocator<1>>;
+
+	/**
+	 * Returns the actor owning the specified object, if the object is the actor itself or one of its mesh components.
+	 */
+	static const AActor* GetOwnerOf(const UObject* Object);
+
+	/**
+	 * Notifies all listeners on the actor owning the specified object, if the object is the actor itself or one of its mesh components.
+	 */
+	void NotifyOwnerOf(const UObject* Object);
+
+	void HandleRenderStateDirty(UActorComponent& Component);
+	void HandleEndFrame();
+	void HandlePhysicsStateChanged(UActorComponent* Component);
+#if WITH_EDITOR
+	void HandleObjectModified(UObject* Object);
+	void HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+#endif
+
+	TMap<TObjectKey<AActor>, FListeners> ListenersByOwner;
+
+	/**
+	 * Actors with listeners whose components' render state was dirtied this frame, to check at the end of the frame.
+	 */
+	TSet<TObjectKey<AActor>> DirtyOwners;
+
+	/**
+	 * The actor each listener was added for, so it's found again once the listener has no owner.
+	 */
+	TMap<TObjectKey<USimpleSurfaceComponent>, TObjectKey<AActor>> OwnersByListener;
+
+	FDelegateHandle RenderStateDirtyHandle;
+	FDelegateHandle CreatePhysicsHandle;
+	FDelegateHandle DestroyPhysicsHandle;
+	FDelegateHandle EndFrameHandle;
+#if WITH_EDITOR
+	FDelegateHandle ObjectModifiedHandle;
+	FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+};
@@ -13,12 +13,24 @@
 
 #include "SimpleSurfaceComponent.h"
 
+#include "SimpleSurfaceChangeRouter.h"
+#include "SimpleSurfaceCustomData.h"
+#include "SimpleSurfaceMeshIdentity.h"
+#include "SimpleSurfacePreset.h"
+#include "SimpleSurfaceStats.h"
+#include "SimpleSurfaceSubsystem.h"
+#include "Algo/AnyOf.h"
 #include "GameFramework/Actor.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Components/MeshComponent.h"
+#include "Engine/AssetManager.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Materials/MaterialInstance.h"
 #include "Materials/MaterialInterface.h"
+#include "Misc/ScopeExit.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/ActorComponent.h"
@@ -35,187 +47,268 @@ DEFINE_LOG_CATEGORY(LogSimpleSurface);
 
 void USimpleSurfaceComponent::DestroyComponent(const bool bPromoteChildren)
 {
-	TryRestoreMaterials();
+	// A replacement takes the meshes over; the subsystem restores them only if none turns up.
+	auto Subsystem = GetSurfaceSubsystem();
+	if (bHandedOffCatalog && Subsystem && GetOwner())
+	{
+		CancelMaterialRestore();
+		Subsystem->QueueOrphanedCatalog(*GetOwner(), MeshCatalog);
+	}
+	else
+	{
+		// Nothing would be left to finish an asynchronous restore.
+		TryRestoreMaterials(/*bWaitForLoads=*/true);
+	}
 	Super::DestroyComponent(bPromoteChildren);
 }
 
+TStructOnScope<FActorComponentInstanceData> USimpleSurfaceComponent::GetComponentInstanceData() const
+{
+	bHandedOffCatalog = true;
+	return MakeStructOnScope<FActorComponentInstanceData, FSimpleSurfaceComponentInstanceData>(this);
+}
+
+FSimpleSurfaceComponentInstanceData::FSimpleSurfaceComponentInstanceData(const USimpleSurfaceComponent* SourceComponent)
+	: FActorComponentInstanceData(SourceComponent)
+	, MeshCatalog(SourceComponent->MeshCatalog)
+{
+}
+
+void FSimpleSurfaceComponentInstanceData::ApplyToComponent(UActorComponent* Component, const ECacheApplyPhase CacheApplyPhase)
+{
+	Super::ApplyToComponent(Component, CacheApplyPhase);
+
+	auto SurfaceComponent = CastChecked<USimpleSurfaceComponent>(Component);
+	if (CacheApplyPhase != ECacheApplyPhase::PostUserConstructionScript)
+	{
+		return;
+	}
+
+	// The replacement captured the meshes already showing SimpleSurface; what they showed before comes from the
+	// catalog it replaces.  It only captured meshes of its own first, e.g. ones the construction script created anew.
+	FSimpleSurfaceMeshCatalog OwnCatalog = MoveTemp(SurfaceComponent->MeshCatalog);
+	SurfaceComponent->MeshCatalog = MeshCatalog;
+	SurfaceComponent->MeshCatalog.Merge(OwnCatalog);
+}
+
+void USimpleSurfaceComponent::SetParameter_Preset(USimpleSurfacePreset* InPreset)
+{
+	this->Preset = InPreset;
+	MarkParametersDirty();
+}
+
+void USimpleSurfaceComponent::SetParameter_PresetOverrides(const int32 InOverrides)
+{
+	this->PresetOverrides = InOverrides;
+	MarkParametersDirty();
+}
+
+bool USimpleSurfaceComponent::OverridesPreset(const ESimpleSurfacePresetField Field) const
+{
+	return !Preset || EnumHasAnyFlags(static_cast<ESimpleSurfacePresetField>(PresetOverrides), Field);
+}
+
+void USimpleSurfaceComponent::OverridePreset(const ESimpleSurfacePresetField Field)
+{
+	if (Preset)
+	{
+		PresetOverrides |= static_cast<int32>(Field);
+	}
+}
+
+bool USimpleSurfaceComponent::UsesPresetMaterial() const
+{
+	return Preset && PresetOverrides == 0 && !Animation.IsEnabled() && !bIsDistant && !UsesCustomPrimitiveData();
+}
+
+TSoftObjectPtr<UTexture> USimpleSurfaceComponent::GetTextureOverride() const
+{
+	return OverridesPreset(ESimpleSurfacePresetField::Texture) ? Texture : Preset->Texture;
+}
+
+void USimpleSurfaceComponent::UpdatePresetSubscription()
+{
+	if (SubscribedPreset == Preset)
+	{
+		return;
+	}
+
+	if (auto OldPreset = SubscribedPreset.Get())
+	{
+		OldPreset->OnPresetChanged().Remove(PresetChangedHandle);
+	}
+	PresetChangedHandle.Reset();
+	SubscribedPreset = Preset;
+
+	if (Preset)
+	{
+		PresetChangedHandle = Preset->OnPresetChanged().AddUObject(this, &USimpleSurfaceComponent::OnPresetChanged);
+	}
+}
+
+void USimpleSurfaceComponent::OnPresetChanged(const bool bFeaturesChanged)
+{
+	// The preset already updated its own instance, which is all that surfaces rendering through it need.
+	if (!bFeaturesChanged && UsesPresetMaterial() && Preset->IsPresetMaterial(SimpleSurfaceMaterial))
+	{
+		return;
+	}
+
+	MarkParametersDirty();
+}
+
 void USimpleSurfaceComponent::SetParameter_Color(const FColor& InColor)
 {
 	this->Color = InColor;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::Color);
+	MarkParametersDirty();
 }
 
 void USimpleSurfaceComponent::SetParameter_Glow(const float& InGlow)
 {
 	this->Glow = InGlow;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::Glow);
+	MarkParametersDirty();
 }
 
 void USimpleSurfaceComponent::SetParameter_ShininessRoughness(const float& InValue)
 {
 	this->ShininessRoughness = InValue;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::ShininessRoughness);
+	MarkParametersDirty();
 }
 
 void USimpleSurfaceComponent::SetParameter_WaxinessMetalness(const float& InValue)
 {
 	this->WaxinessMetalness = InValue;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::WaxinessMetalness);
+	MarkParametersDirty();
 }
 
-void USimpleSurfaceComponent::SetParameter_Texture(UTexture* InTexture)
+void USimpleSurfaceComponent::SetParameter_Texture(const TSoftObjectPtr<UTexture>& InTexture)
 {
 	this->Texture = InTexture;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::Texture);
+	MarkParametersDirty();
 }
 
 void USimpleSurfaceComponent::SetParameter_TextureIntensity(const float& InValue)
 {
 	this->TextureIntensity = InValue;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::TextureIntensity);
+	MarkParametersDirty();
 }
 
 void USimpleSurfaceComponent::SetParameter_TextureScale(const float& InValue)
 {
 	this->TextureScale = InValue;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::TextureScale);
+	MarkParametersDirty();
 }
 
 void USimpleSurfaceComponent::SetParameter_ShowGrid(const float& InValue)
 {
 	this->ShowGrid = InValue;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::ShowGrid);
+	MarkParametersDirty();
 }
 
 void USimpleSurfaceComponent::SetParameter_GridSettings(const FSimpleSurfaceGridParams& InParams)
 {
 	this->GridParams = InParams;
-	ApplyParametersToMaterial();
+	OverridePreset(ESimpleSurfacePresetField::GridParams);
+	MarkParametersDirty();
 }
 
-FMeshCatalogRecord::FMeshCatalogRecord() = default;
-
-FMeshCatalogRecord::FMeshCatalogRecord(UMeshComponent& Component,
-	const TArray<const TSoftClassPtr<UMaterialInterface>>& Ex)
+void USimpleSurfaceComponent::MarkParametersDirty()
 {
-	ExcludedMaterialClasses = Ex;
-	UpdateRecord(Component);
-}
+	if (bParametersDirty)
+	{
+		return;
+	}
 
-void FMeshCatalogRecord::UpdateRecord(UMeshComponent& Component)
-{
-	MeshHash = GetMeshHash(&Component);
-	IndexPath = GetIndexPath(Component);
-	UpdateMaterialsBySlot(Component);
-}
+	// Nothing to push to until the component is registered, and registering applies the parameters anyway.
+	if (!IsRegistered())
+	{
+		return;
+	}
 
-TArray<int32> FMeshCatalogRecord::GetIndexPath(UMeshComponent& MeshComponent)
-{
-	TArray<int32> Result;
-	USceneComponent* Current = &MeshComponent;
-	while (Current)
+	bParametersDirty = true;
+
+	// Coalesce every parameter set this frame, on every component, into one flush at the end of the frame.
+	if (auto Subsystem = GetSurfaceSubsystem())
 	{
-		if (auto Parent = Cast<USceneComponent>(Current->GetAttachParent()))
-		{
-			Result.Insert(Parent->GetAttachChildren().Find(Current), 0);
-			Current = Parent;
-		}
-		else
-		{
-			break;
-		}
+		Subsystem->QueueParameterFlush(*this);
+	}
+	else
+	{
+		FlushSurfaceParameters();
 	}
-		
-	return Result;
 }
 
-UMeshComponent* FMeshCatalogRecord::LocateComponent(const AActor& Actor)
+void USimpleSurfaceComponent::FlushSurfaceParameters()
 {
-	// Locate the component corresponding to IndexPath.
-	USceneComponent* Current = Actor.GetRootComponent();
-	for (auto Index : IndexPath)
+	if (bParametersDirty)
 	{
-		if (Current)
-		{
-			auto Children = Current->GetAttachChildren();
-			if (Index < Children.Num())
-			{
-				Current = Children[Index];
-			}
-			else
-			{
-				Current = nullptr;
-			}
-		}
-		else
-		{
-			break;
-		}
+		ApplyParametersToMaterial();
 	}
-
-	return Cast<UMeshComponent>(Current);
 }
 
-void FMeshCatalogRecord::ApplyMaterials(UMeshComponent& MeshComponent) const
+bool USimpleSurfaceComponent::PlayAnimation(const FSimpleSurfaceAnimation& InAnimation)
 {
-	for (int32 i = 0; i < MaterialsBySlot.Num(); ++i)
+	// An animation takes the surface off custom primitive data and distance LOD, which isn't worth it for nothing.
+	if (!SupportsAnimation())
 	{
-		auto SoftMaterialPtr = MaterialsBySlot[i];
-		if (const auto Material = SoftMaterialPtr.IsValid() ? SoftMaterialPtr.Get() : SoftMaterialPtr.LoadSynchronous())
-		{
-			MeshComponent.SetMaterial(i, Material);
-		}
+		UE_LOG(LogSimpleSurface, Warning, TEXT("%s can't play an animation: its material doesn't read the animation parameters."), *GetPathName())
+		return false;
 	}
+
+	const UWorld* World = GetWorld();
+	Animation = InAnimation;
+	Animation.StartTime = World ? World->GetTimeSeconds() : 0.0f;
+	MarkParametersDirty();
+	return true;
 }
 
-void FMeshCatalogRecord::UpdateMaterialsBySlot(const UMeshComponent& MeshComponent)
+void USimpleSurfaceComponent::StopAnimation()
 {
-	// Take care to update the slots one by one, don't just copy the array; because we don't want to capture
-	// excluded materials.
-	MaterialsBySlot.SetNum(MeshComponent.GetNumMaterials());
-	for (auto i = 0; i < MeshComponent.GetNumMaterials(); i++)
+	if (Animation.IsEnabled())
 	{
-		auto Material = MeshComponent.GetMaterial(i);
-		if (Material && !ExcludedMaterialClasses.Contains(Material->GetClass()))
-		{
-			MaterialsBySlot[i] = Material;
-		}
+		Animation = FSimpleSurfaceAnimation();
+		MarkParametersDirty();
 	}
 }
 
-bool FMeshCatalogRecord::MeshEquals(UMeshComponent& Component) const
+bool USimpleSurfaceComponent::IsAnimationPlaying() const
 {
-	return MeshHash == GetMeshHash(&Component);
+	const UWorld* World = GetWorld();
+	return World && Animation.IsPlaying(World->GetTimeSeconds());
 }
 
-bool FMeshCatalogRecord::operator==(const FMeshCatalogRecord& Other) const
+bool USimpleSurfaceComponent::SupportsAnimation() const
 {
-	return MeshHash == Other.MeshHash && MaterialsBySlot == Other.MaterialsBySlot;
+	// Permutations are instances of the base material, so they expose the same parameters.
+	if (!BaseMaterial)
+	{
+		return false;
+	}
+
+	float Mode;
+	FLinearColor Value;
+	return BaseMaterial->GetScalarParameterValue(FHashedMaterialParameterInfo(SimpleSurfaceParameterNames::AnimationMode), Mode)
+		&& BaseMaterial->GetVectorParameterValue(FHashedMaterialParameterInfo(SimpleSurfaceParameterNames::AnimationTarget), Value)
+		&& BaseMaterial->GetVectorParameterValue(FHashedMaterialParameterInfo(SimpleSurfaceParameterNames::AnimationTiming), Value);
 }
 
-uint32 FMeshCatalogRecord::GetMeshHash(UMeshComponent* MeshComponent)
+void USimpleSurfaceComponent::SetParameter_InstanceVariation(const FSimpleSurfaceInstanceVariation& InVariation)
 {
-	if (!MeshComponent)
-	{
-		return 0;
-	}
-		
-	auto HashValue = GetTypeHash(MeshComponent);
+	this->InstanceVariation = InVariation;
 
-	if (UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(MeshComponent))
-	{
-		HashValue = HashCombine(HashValue, GetTypeHash(StaticMeshComponent->GetStaticMesh()));
-	}
-	else if (UDynamicMeshComponent* DynamicMeshComponent = Cast<UDynamicMeshComponent>(MeshComponent))
-	{
-		HashValue = HashCombine(HashValue, GetTypeHash(DynamicMeshComponent->GetDynamicMesh()->GetTriangleCount()));
-	}
-	else
+	// Turning variation on or off changes the material of instanced meshes, not just their data.
+	if (IsRegistered() && IsActive() && GetSurfaceMaterial())
 	{
-		HashValue = 0;
+		ApplyMaterialToMeshes();
 	}
-
-	return HashValue;
 }
 
 // Sets default values for this component's properties
@@ -240,324 +333,1075 @@ USimpleSurfaceComponent::USimpleSurfaceComponent(FObjectInitializer const& Objec
 
 void USimpleSurfaceComponent::ApplyAll()
 {
-	if (SimpleSurfaceMaterial)
+	if (GetSurfaceMaterial())
 	{
 		ApplyParametersToMaterial();
 		ApplyMaterialToMeshes();
 	}
 }
 
-void USimpleSurfaceComponent::Activate(bool bReset)
+void USimpleSurfaceComponent::PostLoad()
 {
-	UpdateMeshCatalog();
-	ApplyAll();
-	Super::Activate(bReset);
+	Super::PostLoad();
+
+	// Older versions kept a record per mesh component; fold those into the flat catalog.
+	for (const auto& ComponentToCatalogRecordKvp : CapturedMeshCatalog_DEPRECATED)
+	{
+		const auto& Record = ComponentToCatalogRecordKvp.Value;
+		MeshCatalog.AddEntry(ComponentToCatalogRecordKvp.Key, Record.MeshHash, Record.MaterialsBySlot, Record.IndexPath);
+	}
+	CapturedMeshCatalog_DEPRECATED.Empty();
 }
 
-void USimpleSurfaceComponent::Deactivate()
+bool USimpleSurfaceComponent::CanBake() const
 {
-	TryRestoreMaterials();
-	Super::Deactivate();
+	return !InstanceVariation.IsEnabled() && !Animation.IsEnabled();
 }
 
-void USimpleSurfaceComponent::InitializeSharedMID()
+bool USimpleSurfaceComponent::HasCurrentBake() const
 {
-	UE_LOG(LogSimpleSurface, Verbose, TEXT("Initializing shared MID with outer %s (%p)"), *GetName(), this)
+	const auto BakedInstance = Cast<UMaterialInstance>(BakedMaterial);
+	return BakedInstance && BakedInstance->Parent == GetParentMaterial() && BakedParameters == GetSurfaceParameters() && CanBake();
+}
 
-	// When duplicating actors, we must ensure that duplicated SimpleSurfaceComponents get their own instance of the SimpleSurfaceMaterial.
-	if (!SimpleSurfaceMaterial || SimpleSurfaceMaterial.GetOuter() != this)
+UMaterialInterface* USimpleSurfaceComponent::GetParentMaterial() const
+{
+	if (UMaterialInterface* Permutation = USimpleSurfaceSubsystem::GetPermutationMaterial(GetSurfaceParameters().GetFeatures()))
 	{
-		SimpleSurfaceMaterial = UMaterialInstanceDynamic::Create(BaseMaterial.Get(), this, TEXT("SimpleSurfaceMaterial"));
+		return Permutation;
 	}
+	return BaseMaterial;
 }
 
-void USimpleSurfaceComponent::ApplyParametersToMaterial() const
+UMaterialInterface* USimpleSurfaceComponent::GetInstanceParentMaterial() const
 {
-	check(SimpleSurfaceMaterial.Get())
-	SimpleSurfaceMaterial->SetVectorParameterValue("Color", Color);
-	SimpleSurfaceMaterial->SetScalarParameterValue("Glow", Glow);
-	SimpleSurfaceMaterial->SetScalarParameterValue("Waxiness / Metalness", WaxinessMetalness);
-	SimpleSurfaceMaterial->SetScalarParameterValue("Shininess / Roughness", ShininessRoughness);
-
-	SimpleSurfaceMaterial->SetTextureParameterValue("Texture", Texture.Get());
-	SimpleSurfaceMaterial->SetScalarParameterValue("Texture Intensity", TextureIntensity);
-	SimpleSurfaceMaterial->SetScalarParameterValue("Texture Scale", TextureScale);
-
-	SimpleSurfaceMaterial->SetScalarParameterValue("Show Grid", ShowGrid);
-	SimpleSurfaceMaterial->SetScalarParameterValue("Grid Size", GridParams.GridSize);
-	SimpleSurfaceMaterial->SetScalarParameterValue("Sub Grid Number", GridParams.SubGridDivisions);
-	SimpleSurfaceMaterial->SetScalarParameterValue("ObjectAligned", GridParams.bIsObjectAligned ? 1.0f : 0.0f);
+	// An animation drives glow the flat permutation lacks, so animated surfaces stay on their full material.
+	if (bIsDistant && !Animation.IsEnabled())
+	{
+		if (UMaterialInterface* FlatPermutation = USimpleSurfaceSubsystem::GetPermutationMaterial(ESimpleSurfaceFeatures::None))
+		{
+			return FlatPermutation;
+		}
+	}
+	return GetParentMaterial();
 }
 
-void USimpleSurfaceComponent::ApplyMaterialToMeshes() const
+void USimpleSurfaceComponent::UpdateDistanceLOD()
 {
-	if (!GetOwner())
+	auto Subsystem = GetSurfaceSubsystem();
+	if (!Subsystem)
 	{
 		return;
 	}
 
-	TArray<UMeshComponent*> MeshComponents;
-	GetOwner()->GetComponents<UMeshComponent>(MeshComponents);
-
-	check(SimpleSurfaceMaterial.Get())
-
-	for (auto MeshComponent : MeshComponents)
+	if (bUseDistanceLOD && IsRegistered())
 	{
-		for (auto i = 0; i < MeshComponent->GetNumMaterials(); i++)
-		{
-			// To avoid spurious edits that will prompt the user to save their file even if they haven't changed anything, only change materials when necessary.
-			auto Material = MeshComponent->GetMaterial(i);
-			if (Material != SimpleSurfaceMaterial.Get())
-			{
-				// Ensure undo/redo capture for all components whose materials we're changing.
-				MeshComponent->Modify();
-			
-				MeshComponent->SetMaterial(i, SimpleSurfaceMaterial.Get());
-			}
-		}
+		Subsystem->StartDistanceLOD(*this);
 	}
-}
-
-ComponentMaterialMap USimpleSurfaceComponent::CreateComponentMaterialMap() const
-{
-	if (!GetOwner())
+	else if (bIsDistant)
 	{
-		return {};
+		Subsystem->StopDistanceLOD(*this);
+		MarkParametersDirty();
 	}
-	
-	ComponentMaterialMap ResultMap;
-	TArray<TObjectPtr<UMeshComponent>> AllMeshComponents;
-	GetOwner()->GetComponents<UMeshComponent>(AllMeshComponents);
-	
-	for (const auto& MeshComponent : AllMeshComponents)
+	else
 	{
-		TMap<int32, TObjectPtr<UMaterialInterface>> MaterialMap;
-		for (int32 i = 0; i < MeshComponent->GetNumMaterials(); i++)
-		{
-			TObjectPtr<UMaterialInterface> MatInterface = MeshComponent->GetMaterial(i);
-			MaterialMap.Add(i, MatInterface);
-		}
-		ResultMap.Add(MeshComponent, MaterialMap);
+		Subsystem->StopDistanceLOD(*this);
 	}
-
-	return ResultMap;
 }
 
-void USimpleSurfaceComponent::UpdateComponentMaterialMap(ComponentMaterialMap& InOutMap) const
+#if WITH_EDITOR
+void USimpleSurfaceComponent::PreSave(FObjectPreSaveContext SaveContext)
 {
-	if (!GetOwner())
-	{
-		return;		
-	}
+	Super::PreSave(SaveContext);
 
-	TArray<UMeshComponent*, TInlineAllocator<32>> CurrentComponentsArray;
-	GetOwner()->GetComponents<UMeshComponent>(CurrentComponentsArray);
-	TSet<TObjectPtr<UMeshComponent>> CurrentComponentsSet;
-	Algo::Transform(CurrentComponentsArray, CurrentComponentsSet, [](UMeshComponent* x) { return TObjectPtr<UMeshComponent>(x); });
+	// In case the previous save failed before its package was reported saved.
+	RestoreOverridesAfterCook();
 
-	TSet<TObjectPtr<UMeshComponent>> OldKeys;
-	InOutMap.GetKeys(OldKeys);
-
-	auto NewComponents = CurrentComponentsSet.Difference(OldKeys);
-	auto MissingComponents = OldKeys.Difference(CurrentComponentsSet);
-	auto ExistingComponents = CurrentComponentsSet.Intersect(OldKeys);
-	
-	// Add new components
-	for (const auto& NewComponent : NewComponents)
+	// A current bake's texture needs no loading here: the baked parameters reference it, so it's loaded with them.
+	bStrippedForCook = SaveContext.IsCooking() && HasCurrentBake() && GetOwner();
+	if (!bStrippedForCook)
 	{
-		auto MaterialsBySlot = TMap<int32, TObjectPtr<UMaterialInterface>>();
-		for (int32 i = 0; i < NewComponent->GetNumMaterials(); i++)
+		if (SaveContext.IsCooking() && BakedMaterial)
 		{
-			MaterialsBySlot.Add(i, NewComponent->GetMaterial(i));
+			UE_LOG(LogSimpleSurface, Warning, TEXT("%s changed since it was baked; cooking it unbaked.  Run the SimpleSurfaceBake commandlet again."), *GetPathName())
 		}
-		InOutMap.Add(NewComponent, MaterialsBySlot);
+		return;
 	}
 
-	// Remove old components
-	for (const auto& MissingComponent : MissingComponents)
+	// The meshes' saved overrides are what the cooked game sees; pooled instances are transient and would be saved as null.
+	// Only the saved overrides change, and only until the package is saved, so the editor's meshes are left as they are:
+	// no render state update, no transaction and no dirty package.
+	TArray<UMeshComponent*, TInlineAllocator<32>> MeshComponents;
+	GetOwner()->GetComponents<UMeshComponent>(MeshComponents);
+	for (const auto MeshComponent : MeshComponents)
 	{
-		InOutMap.Remove(MissingComponent);
+		const int32 NumMaterials = MeshComponent->GetNumMaterials();
+		OverridesDuringCook.Emplace(MeshComponent, MoveTemp(MeshComponent->OverrideMaterials));
+		MeshComponent->OverrideMaterials.Init(BakedMaterial, NumMaterials);
 	}
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddUObject(this, &USimpleSurfaceComponent::HandlePackageSaved);
+}
+
+void USimpleSurfaceComponent::RestoreOverridesAfterCook()
+{
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+	PackageSavedHandle.Reset();
 
-	// Update existing components
-	for (const auto& ExistingComponent : ExistingComponents)
+	for (auto& Overrides : OverridesDuringCook)
 	{
-		auto& MaterialsBySlot = InOutMap[ExistingComponent];
-		MaterialsBySlot.Reset();
-		for (int32 i = 0; i < ExistingComponent->GetNumMaterials(); i++)
+		if (const auto MeshComponent = Overrides.Key.Get())
 		{
-			UMaterialInterface* ExistingMaterial = ExistingComponent->GetMaterial(i);
-			if (!ExistingMaterial->IsA(SimpleSurfaceMaterial.GetClass()))
-			{
-				MaterialsBySlot.Add(i, ExistingMaterial);
-			}
+			MeshComponent->OverrideMaterials = MoveTemp(Overrides.Value);
 		}
 	}
+	OverridesDuringCook.Reset();
 }
 
-TArray<int32> USimpleSurfaceComponent::GetIndexPath(USceneComponent& Component)
+void USimpleSurfaceComponent::HandlePackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext)
 {
-	TArray<int32> IndexPath;
-	auto Parent = Component.GetAttachParent();
-	while (Parent)
+	if (Package == GetPackage())
 	{
-		auto Index = Parent->GetAttachChildren().Find(&Component);
-		if (Index == INDEX_NONE)
-		{
-			break;
-		}
-		IndexPath.Insert(Index, 0);
-		Parent = Parent->GetAttachParent();
+		RestoreOverridesAfterCook();
 	}
-	return IndexPath;	
 }
+#endif
 
-void USimpleSurfaceComponent::UpdateMeshCatalog()
+bool USimpleSurfaceComponent::NeedsLoadForClient() const
 {
-	if (!GetOwner() || !SimpleSurfaceMaterial)
-	{
-		return;
-	}	
-	
-	// Update our records of all mesh components' current materials.
-	TArray<TObjectPtr<UMeshComponent>> AllMeshComponents;
-	GetOwner()->GetComponents<UMeshComponent>(AllMeshComponents);
-	CapturedMeshComponentCount = AllMeshComponents.Num();
-	for (const auto& MeshComponent : AllMeshComponents)
-	{
-		if (!MeshComponent.Get())
-		{
-			CapturedMeshCatalog.Remove(MeshComponent);
-			continue;
-		}
+	return !bStrippedForCook && Super::NeedsLoadForClient();
+}
 
-		if (auto FoundCatalogRecord = CapturedMeshCatalog.Find(MeshComponent))
-		{
-			FoundCatalogRecord->UpdateRecord(*MeshComponent);			
-		}
-		else
-		{
-			CapturedMeshCatalog.Add(MeshComponent, FMeshCatalogRecord(*MeshComponent, { SimpleSurfaceMaterial.GetClass() }));
-		}
-	}
+bool USimpleSurfaceComponent::NeedsLoadForServer() const
+{
+	return !bStrippedForCook && Super::NeedsLoadForServer();
 }
 
-void USimpleSurfaceComponent::TryRestoreMaterials()
+void USimpleSurfaceComponent::Activate(bool bReset)
 {
-	if (!GetOwner())
-	{
-		return;
-	}
+	UpdateMeshCatalog();
+	ApplyAll();
+	Super::Activate(bReset);
+	UpdateChangeDetection();
+}
 
-	TSet<TSoftObjectPtr<UMeshComponent>> MarkedForRemoval;
-	
-	for (auto& ComponentToCatalogRecordKvp : CapturedMeshCatalog)
-	{
-		auto const &MeshComponent = ComponentToCatalogRecordKvp.Key;
-		auto const &CatalogRecord = ComponentToCatalogRecordKvp.Value;
+void USimpleSurfaceComponent::Deactivate()
+{
+	TryRestoreMaterials();
+	Super::Deactivate();
+	UpdateChangeDetection();
+}
 
-		// Now restore captured materials.
-		if (auto SafeComponent = MeshComponent.Get())
-		{
-			// Ensure undo/redo capture for all components whose materials we're reverting.
-			MeshComponent->Modify();
-			
-			// Start by clearing all override materials, including SimpleSurface.
-			MeshComponent->EmptyOverrideMaterials();
+USimpleSurfaceSubsystem* USimpleSurfaceComponent::GetSurfaceSubsystem() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<USimpleSurfaceSubsystem>() : nullptr;
+}
 
-			CatalogRecord.ApplyMaterials(*SafeComponent);
-		}
-		else
-		{
-			// No point keeping the record if the MeshComponent no longer exists.
-			MarkedForRemoval.Add(MeshComponent);
-		}
-	}
+bool USimpleSurfaceComponent::UsesCustomPrimitiveData() const
+{
+	// Texture overrides and animations can't be expressed as custom primitive data, so those surfaces still need a material instance.
+	return RenderMode == ESimpleSurfaceRenderMode::CustomPrimitiveData && GetTextureOverride().IsNull() && !Animation.IsEnabled()
+		&& USimpleSurfaceSubsystem::GetCustomDataMaterial();
+}
 
-	for (auto& Component : MarkedForRemoval)
-	{
-		CapturedMeshCatalog.Remove(Component);
-	}
+UMaterialInterface* USimpleSurfaceComponent::GetSurfaceMaterial() const
+{
+	return UsesCustomPrimitiveData() ? USimpleSurfaceSubsystem::GetCustomDataMaterial() : SimpleSurfaceMaterial.Get();
 }
 
-bool USimpleSurfaceComponent::MonitorForChanges() const
+bool USimpleSurfaceComponent::UsesInstanceVariation(const UMeshComponent& MeshComponent) const
 {
-	if (!GetOwner())
+	return InstanceVariation.IsEnabled() && MeshComponent.IsA<UInstancedStaticMeshComponent>() && USimpleSurfaceSubsystem::GetCustomDataMaterial();
+}
+
+UMaterialInterface* USimpleSurfaceComponent::GetSurfaceMaterialFor(const UMeshComponent& MeshComponent) const
+{
+	// Per-instance data is read by the custom data material, whatever the render mode.
+	return UsesInstanceVariation(MeshComponent) ? USimpleSurfaceSubsystem::GetCustomDataMaterial() : GetSurfaceMaterial();
+}
+
+bool USimpleSurfaceComponent::IsSurfaceMaterial(const UMaterialInterface* Material) const
+{
+	return Material && (Material->IsA<UMaterialInstanceDynamic>() || Material == USimpleSurfaceSubsystem::GetCustomDataMaterial()
+		|| Material == BakedMaterial);
+}
+
+void USimpleSurfaceComponent::InitializeSharedMID()
+{
+	if (UsesCustomPrimitiveData())
 	{
-		return false;
+		// Every custom-data surface shares one static material; there's no instance to create.
+		ReleasePooledMaterial();
+		SimpleSurfaceMaterial = nullptr;
+		return;
 	}
-	
-	bool bChangeOccurred = false;
 
-	TArray<UMeshComponent*, TInlineAllocator<32>> CurrentMeshComponents;
-	GetOwner()->GetComponents<UMeshComponent>(CurrentMeshComponents);
-	int32 CurrentMeshComponentCount = CurrentMeshComponents.Num();
-	
-	// Has the number of mesh components changed?
-	if (CurrentMeshComponentCount != CapturedMeshComponentCount)
+	if (UsesPresetMaterial())
 	{
-		bChangeOccurred = true;
+		UMaterialInstanceDynamic* PresetMaterial = Preset->GetMaterial(GetParentMaterial());
+		ReleasePooledMaterial();
+		SimpleSurfaceMaterial = PresetMaterial;
+		return;
 	}
 
-	// Have any of the components' meshes changed?
-	for (auto& ComponentToCatalogRecordKvp : CapturedMeshCatalog)
+	if (auto Subsystem = GetSurfaceSubsystem())
 	{
-		auto const &MeshComponent = ComponentToCatalogRecordKvp.Key;
-		auto const &CatalogRecord = ComponentToCatalogRecordKvp.Value;
-
-		auto SafeMeshComponent = MeshComponent.Get();
-		if (!CatalogRecord.MeshEquals(*SafeMeshComponent))
-		{
-			bChangeOccurred = true;
-			break;
-		}
+		// Components with identical parameters share one pooled instance, which also takes care of duplicated actors:
+		// a duplicate's SimpleSurfaceMaterial is reset, and it acquires its own reference to the pooled instance.
+		AcquirePooledMaterial(*Subsystem);
+		return;
 	}
 
-	// Are there any materials in use that aren't SimpleSurface?
-	// This indicates that a mesh has changed, and the new mesh has more material slots than the old mesh.
-	for (auto Component : CurrentMeshComponents)
-	{
-		if (Component->GetNumMaterials() == 0)
-		{
+	UE_LOG(LogSimpleSurface, Verbose, TEXT("Initializing shared MID with outer %s (%p)"), *GetName(), this)
+
+	// When duplicating actors, we must ensure that duplicated SimpleSurfaceComponents get their own instance of the SimpleSurfaceMaterial.
+	if (!SimpleSurfaceMaterial || SimpleSurfaceMaterial.GetOuter() != this)
+	{
+		SimpleSurfaceMaterial = UMaterialInstanceDynamic::Create(GetInstanceParentMaterial(), this, TEXT("SimpleSurfaceMaterial"));
+	}
+}
+
+FSimpleSurfaceParameters USimpleSurfaceComponent::GetSurfaceParameters() const
+{
+	FSimpleSurfaceParameters Parameters = Preset ? Preset->GetParameters() : FSimpleSurfaceParameters();
+	auto Override = [this](const ESimpleSurfacePresetField Field, auto& Value, const auto& OwnValue)
+	{
+		if (OverridesPreset(Field))
+		{
+			Value = OwnValue;
+		}
+	};
+	Override(ESimpleSurfacePresetField::Color, Parameters.Color, Color);
+	Override(ESimpleSurfacePresetField::Glow, Parameters.Glow, Glow);
+	Override(ESimpleSurfacePresetField::ShininessRoughness, Parameters.ShininessRoughness, ShininessRoughness);
+	Override(ESimpleSurfacePresetField::WaxinessMetalness, Parameters.WaxinessMetalness, WaxinessMetalness);
+	Override(ESimpleSurfacePresetField::TextureIntensity, Parameters.TextureIntensity, TextureIntensity);
+	Override(ESimpleSurfacePresetField::TextureScale, Parameters.TextureScale, TextureScale);
+	Override(ESimpleSurfacePresetField::ShowGrid, Parameters.ShowGrid, ShowGrid);
+	Override(ESimpleSurfacePresetField::GridParams, Parameters.GridParams, GridParams);
+	Parameters.Texture = GetTextureOverride().Get();
+	Parameters.Animation = Animation;
+	return Parameters;
+}
+
+void USimpleSurfaceComponent::AcquirePooledMaterial(USimpleSurfaceSubsystem& Subsystem)
+{
+	// Acquire before releasing, so an instance isn't dropped from the pool when we're moving to the same one.
+	UMaterialInstanceDynamic* PooledMaterial = Subsystem.AcquireMaterial(GetInstanceParentMaterial(), GetSurfaceParameters());
+	ReleasePooledMaterial();
+	SimpleSurfaceMaterial = PooledMaterial;
+}
+
+void USimpleSurfaceComponent::ReleasePooledMaterial()
+{
+	if (auto Subsystem = GetSurfaceSubsystem(); Subsystem && Subsystem->IsPooledMaterial(SimpleSurfaceMaterial))
+	{
+		Subsystem->ReleaseMaterial(SimpleSurfaceMaterial);
+		SimpleSurfaceMaterial = nullptr;
+	}
+}
+
+void USimpleSurfaceComponent::ApplyParametersToMaterial()
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_ApplyParametersToMaterial);
+
+	bParametersDirty = false;
+
+	if (IsRegistered())
+	{
+		UpdatePresetSubscription();
+		UpdateTextureRequest();
+	}
+
+	// Switching render modes, or setting or clearing a texture override in custom data mode, changes what kind of material we need.
+	if (UsesCustomPrimitiveData() == (SimpleSurfaceMaterial != nullptr))
+	{
+		if (!IsRegistered())
+		{
+			return;
+		}
+
+		const bool bWasUsingCustomData = !SimpleSurfaceMaterial;
+		InitializeSharedMID();
+		if (IsActive())
+		{
+			if (bWasUsingCustomData)
+			{
+				ClearCustomData();
+			}
+			ApplyMaterialToMeshes();
+		}
+		return;
+	}
+
+	// Instance variation is derived from the surface's parameters.
+	if (IsActive() && !VariedInstanceCounts.IsEmpty()
+		&& (!InstanceVariationParameters.IsSet() || InstanceVariationParameters.GetValue() != GetSurfaceParameters()))
+	{
+		ApplyInstanceVariation();
+	}
+
+	if (UsesCustomPrimitiveData())
+	{
+		// Only rewrite the meshes' custom data when parameters changed; ApplyMaterialToMeshes covers new meshes.
+		// The data lives on the meshes, so leave them alone while deactivated.
+		const FSimpleSurfaceParameters Parameters = GetSurfaceParameters();
+		if (IsActive() && (!CustomDataParameters.IsSet() || CustomDataParameters.GetValue() != Parameters))
+		{
+			ApplyParametersToCustomData();
+		}
+		return;
+	}
+
+	check(SimpleSurfaceMaterial.Get())
+
+	// Surfaces using their preset unchanged share its instance, which only the preset edits.
+	if (UsesPresetMaterial())
+	{
+		if (SimpleSurfaceMaterial != Preset->GetMaterial(GetParentMaterial()))
+		{
+			InitializeSharedMID();
+			if (IsActive())
+			{
+				ApplyMaterialToMeshes();
+			}
+		}
+		return;
+	}
+
+	if (auto Subsystem = GetSurfaceSubsystem(); Subsystem && Subsystem->IsPooledMaterial(SimpleSurfaceMaterial))
+	{
+		// Pooled instances are shared, so they're never edited; changing parameters moves this component to another instance.
+		if (!Subsystem->PooledMaterialMatches(SimpleSurfaceMaterial, GetInstanceParentMaterial(), GetSurfaceParameters()))
+		{
+			AcquirePooledMaterial(*Subsystem);
+			if (IsActive())
+			{
+				ApplyMaterialToMeshes();
+			}
+		}
+		return;
+	}
+
+	// The instance can still be another object's, e.g. the preset's, when the surface just stopped using it.
+	if (SimpleSurfaceMaterial->GetOuter() != this)
+	{
+		InitializeSharedMID();
+		if (IsActive())
+		{
+			ApplyMaterialToMeshes();
+		}
+		return;
+	}
+
+	// Turning a feature on or off can move the surface to another permutation, which needs a new instance.
+	if (UMaterialInterface* ParentMaterial = GetInstanceParentMaterial(); SimpleSurfaceMaterial->Parent != ParentMaterial)
+	{
+		SimpleSurfaceMaterial = UMaterialInstanceDynamic::Create(ParentMaterial, this, MakeUniqueObjectName(this, UMaterialInstanceDynamic::StaticClass(), TEXT("SimpleSurfaceMaterial")));
+		ParameterCache.Apply(*SimpleSurfaceMaterial, GetSurfaceParameters());
+		if (IsActive())
+		{
+			ApplyMaterialToMeshes();
+		}
+		return;
+	}
+
+	// This runs every tick while polling; the cache makes it a comparison when nothing changed.
+	ParameterCache.Apply(*SimpleSurfaceMaterial, GetSurfaceParameters());
+}
+
+void USimpleSurfaceComponent::UpdateTextureRequest()
+{
+	const TSoftObjectPtr<UTexture> CurrentTexture = GetTextureOverride();
+	if (RequestedTexture == CurrentTexture)
+	{
+		return;
+	}
+
+	auto Subsystem = GetSurfaceSubsystem();
+	if (Subsystem && !RequestedTexture.IsNull())
+	{
+		Subsystem->ReleaseTexture(RequestedTexture);
+	}
+	RequestedTexture.Reset();
+
+	if (CurrentTexture.IsNull())
+	{
+		return;
+	}
+
+	// Without a subsystem to stream it, or when nothing will wait for it, load the texture now.
+	if (!Subsystem || IsRunningCommandlet())
+	{
+		CurrentTexture.LoadSynchronous();
+	}
+
+	if (Subsystem)
+	{
+		Subsystem->RequestTexture(CurrentTexture, *this);
+		RequestedTexture = CurrentTexture;
+	}
+}
+
+void USimpleSurfaceComponent::ApplyMaterialToMeshes()
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_ApplyMaterialToMeshes);
+
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+
+	// Don't let a restore that's still loading overwrite SimpleSurface later.
+	CancelMaterialRestore();
+
+	TArray<UMeshComponent*> MeshComponents;
+	GetOwner()->GetComponents<UMeshComponent>(MeshComponents);
+
+	check(GetSurfaceMaterial())
+
+	AssignSurfaceMaterial(MeshComponents);
+
+	if (UsesCustomPrimitiveData())
+	{
+		ApplyParametersToCustomData();
+	}
+
+	if (InstanceVariation.IsEnabled() || !VariedInstanceCounts.IsEmpty())
+	{
+		ApplyInstanceVariation();
+	}
+}
+
+void USimpleSurfaceComponent::AssignSurfaceMaterial(TConstArrayView<UMeshComponent*> MeshComponents)
+{
+	TArray<UMaterialInterface*, TInlineAllocator<16>> SlotMaterials;
+	for (auto MeshComponent : MeshComponents)
+	{
+		SlotMaterials.Init(GetSurfaceMaterialFor(*MeshComponent), MeshComponent->GetNumMaterials());
+
+		// To avoid spurious edits that will prompt the user to save their file even if they haven't changed anything, only
+		// slots whose material differs are written.  Outside a transaction this is a re-application (e.g. of a pooled
+		// material after loading) rather than an edit, so don't mark the package dirty.
+		FSimpleSurfaceMeshCatalog::AssignMaterials(*MeshComponent, SlotMaterials, /*bAlwaysMarkDirty=*/false);
+	}
+}
+
+void USimpleSurfaceComponent::ApplyToChangedMeshes()
+{
+	if (!GetOwner() || !GetSurfaceMaterial())
+	{
+		return;
+	}
+
+	ApplyParametersToMaterial();
+
+	TArray<UMeshComponent*, TInlineAllocator<32>> MeshComponents;
+	GetOwner()->GetComponents<UMeshComponent>(MeshComponents);
+	CapturedMeshComponentCount = MeshComponents.Num();
+
+	TArray<UMeshComponent*, TInlineAllocator<32>> ChangedComponents;
+	MeshCatalog.GetChangedComponents(MeshComponents, ChangedComponents);
+	for (auto MeshComponent : MeshComponents)
+	{
+		if (ChangedComponents.Contains(MeshComponent))
+		{
 			continue;
 		}
 
-		for (int32 i = 0; i < Component->GetNumMaterials(); i++)
+		const auto SurfaceMaterial = GetSurfaceMaterialFor(*MeshComponent);
+		for (int32 i = 0; i < MeshComponent->GetNumMaterials(); ++i)
 		{
-			auto Material = Component->GetMaterial(i);
-			if (Material && !Material->IsA(SimpleSurfaceMaterial.GetClass()))
+			if (MeshComponent->GetMaterial(i) != SurfaceMaterial)
 			{
-				bChangeOccurred = true;
+				ChangedComponents.Add(MeshComponent);
 				break;
 			}
 		}
+	}
 
-		if (bChangeOccurred)
+	if (ChangedComponents.IsEmpty())
+	{
+		return;
+	}
+
+	UE_LOG(LogSimpleSurface, Verbose, TEXT("%hs: Re-applying surface to %d of %d mesh components."), FUNC_SIGNATURE, ChangedComponents.Num(), MeshComponents.Num())
+
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+	CancelMaterialRestore();
+
+	MeshCatalog.Capture(ChangedComponents, { USimpleSurfaceSubsystem::GetCustomDataMaterial(), BakedMaterial.Get() });
+	AssignSurfaceMaterial(ChangedComponents);
+}
+
+void USimpleSurfaceComponent::ApplyInstanceVariation()
+{
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+
+	const FSimpleSurfaceParameters Parameters = GetSurfaceParameters();
+
+	TArray<UInstancedStaticMeshComponent*, TInlineAllocator<8>> InstancedMeshComponents;
+	GetOwner()->GetComponents<UInstancedStaticMeshComponent>(InstancedMeshComponents);
+
+	auto PreviouslyVaried = MoveTemp(VariedInstanceCounts);
+	VariedInstanceCounts.Reset();
+
+	for (const auto InstancedMeshComponent : InstancedMeshComponents)
+	{
+		if (UsesInstanceVariation(*InstancedMeshComponent))
 		{
-			break;
+			if (!InstanceDataBeforeVariation.Contains(InstancedMeshComponent))
+			{
+				InstanceDataBeforeVariation.Add(InstancedMeshComponent, SimpleSurfaceCustomData::CaptureInstances(*InstancedMeshComponent));
+			}
+			const int32 NumInstances = SimpleSurfaceCustomData::WriteInstances(*InstancedMeshComponent, Parameters, InstanceVariation);
+			VariedInstanceCounts.Add(InstancedMeshComponent, NumInstances);
+		}
+		else if (PreviouslyVaried.Contains(InstancedMeshComponent))
+		{
+			// Variation was turned off; don't leave our data behind.
+			SimpleSurfaceCustomData::FInstanceData DataBeforeVariation;
+			InstanceDataBeforeVariation.RemoveAndCopyValue(InstancedMeshComponent, DataBeforeVariation);
+			SimpleSurfaceCustomData::ClearInstances(*InstancedMeshComponent, DataBeforeVariation);
 		}
 	}
+
+	InstanceVariationParameters = Parameters;
+}
+
+void USimpleSurfaceComponent::ClearInstanceVariation()
+{
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+
+	for (const auto& VariedInstances : VariedInstanceCounts)
+	{
+		if (const auto InstancedMeshComponent = VariedInstances.Key.Get())
+		{
+			SimpleSurfaceCustomData::ClearInstances(*InstancedMeshComponent, InstanceDataBeforeVariation.FindRef(VariedInstances.Key));
+		}
+	}
+
+	VariedInstanceCounts.Reset();
+	InstanceDataBeforeVariation.Reset();
+	InstanceVariationParameters.Reset();
+}
+
+void USimpleSurfaceComponent::ApplyParametersToCustomData()
+{
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+
+	const FSimpleSurfaceParameters Parameters = GetSurfaceParameters();
+	const auto Packed = SimpleSurfaceCustomData::Pack(Parameters);
+
+	TArray<UMeshComponent*, TInlineAllocator<32>> MeshComponents;
+	GetOwner()->GetComponents<UMeshComponent>(MeshComponents);
+	for (const auto MeshComponent : MeshComponents)
+	{
+		SimpleSurfaceCustomData::Write(*MeshComponent, Packed);
+	}
+
+	CustomDataParameters = Parameters;
+}
+
+void USimpleSurfaceComponent::ClearCustomData()
+{
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+
+	TArray<UMeshComponent*, TInlineAllocator<32>> MeshComponents;
+	GetOwner()->GetComponents<UMeshComponent>(MeshComponents);
+	for (const auto MeshComponent : MeshComponents)
+	{
+		SimpleSurfaceCustomData::Clear(*MeshComponent);
+	}
+
+	CustomDataParameters.Reset();
+}
+
+void USimpleSurfaceComponent::UpdateMeshCatalog()
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_UpdateMeshCatalog);
+
+	if (!GetOwner() || !GetSurfaceMaterial())
+	{
+		return;
+	}	
 	
-	return bChangeOccurred;
+	// Update our records of all mesh components' current materials.
+	TArray<UMeshComponent*, TInlineAllocator<32>> AllMeshComponents;
+	GetOwner()->GetComponents<UMeshComponent>(AllMeshComponents);
+	CapturedMeshComponentCount = AllMeshComponents.Num();
+
+	// Any material instance is excluded by class; the shared custom data material and a baked material (assigned while
+	// cooking from the editor) are static instances and must be excluded by identity.
+	MeshCatalog.Capture(AllMeshComponents, { USimpleSurfaceSubsystem::GetCustomDataMaterial(), BakedMaterial.Get() });
+}
+
+void USimpleSurfaceComponent::InitializeFromCapturedCatalog(FSimpleSurfaceMeshCatalog&& InMeshCatalog, const int32 NumMeshComponents)
+{
+	MeshCatalog = MoveTemp(InMeshCatalog);
+	CapturedMeshComponentCount = NumMeshComponents;
+	bIsCatalogPrepared = true;
+}
+
+void USimpleSurfaceComponent::RestoreImmediately()
+{
+	bHandedOffCatalog = false;
+	TryRestoreMaterials(/*bWaitForLoads=*/true);
+}
+
+void USimpleSurfaceComponent::TryRestoreMaterials(const bool bWaitForLoads)
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_TryRestoreMaterials);
+
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	CancelMaterialRestore();
+
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+
+	// No point keeping entries whose MeshComponent no longer exists.
+	MeshCatalog.RemoveStaleEntries();
+	
+	for (const auto& Entry : MeshCatalog.Entries)
+	{
+		// Now restore captured materials.
+		if (auto SafeComponent = Entry.Component.Get())
+		{
+			// Writes only the slots that differ from the captured materials, modifying the component at most once for undo.
+			// Slots whose material is still loading are cleared, showing the mesh's own material until it arrives.
+			MeshCatalog.ApplyMaterials(Entry, *SafeComponent);
+
+			if (CustomDataParameters.IsSet())
+			{
+				SimpleSurfaceCustomData::Clear(*SafeComponent);
+			}
+		}
+	}
+
+	TArray<FSoftObjectPath> UnloadedMaterials;
+	MeshCatalog.CollectUnloadedMaterials(UnloadedMaterials);
+
+	CustomDataParameters.Reset();
+	ClearInstanceVariation();
+
+	if (UnloadedMaterials.IsEmpty())
+	{
+		return;
+	}
+
+	// Until the batch completes, slots without a loaded material show whatever the mesh asset assigns them.
+	PendingRestoreHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(UnloadedMaterials), FStreamableDelegate::CreateWeakLambda(this, [this]
+	{
+		if (PendingRestoreHandle.IsValid())
+		{
+			PendingRestoreHandle.Reset();
+			ApplyCapturedMaterials();
+		}
+	}));
+
+	// The batch may also have completed synchronously, before the handle was stored for the callback to see.
+	if (bWaitForLoads || IsRunningCommandlet() || (PendingRestoreHandle.IsValid() && PendingRestoreHandle->HasLoadCompleted()))
+	{
+		FlushMaterialRestore();
+	}
+}
+
+void USimpleSurfaceComponent::ApplyCapturedMaterials()
+{
+	TGuardValue<bool> ApplyingGuard(bIsApplyingSurface, true);
+
+	for (const auto& Entry : MeshCatalog.Entries)
+	{
+		if (auto SafeComponent = Entry.Component.Get())
+		{
+			MeshCatalog.ApplyMaterials(Entry, *SafeComponent);
+		}
+	}
+}
+
+void USimpleSurfaceComponent::FlushMaterialRestore()
+{
+	if (!PendingRestoreHandle.IsValid())
+	{
+		return;
+	}
+
+	// Keep the loaded materials referenced until they've been assigned; the completion callback is then a no-op.
+	const auto Handle = MoveTemp(PendingRestoreHandle);
+	Handle->WaitUntilComplete();
+	ApplyCapturedMaterials();
+	Handle->ReleaseHandle();
+}
+
+void USimpleSurfaceComponent::CancelMaterialRestore()
+{
+	if (const auto Handle = MoveTemp(PendingRestoreHandle))
+	{
+		Handle->CancelHandle();
+	}
+}
+
+bool USimpleSurfaceComponent::MonitorForChanges() const
+{
+	FChangeCheckInputs Inputs;
+	GatherChangeCheckInputs(Inputs);
+	return DetectChanges(Inputs);
+}
+
+void USimpleSurfaceComponent::GatherChangeCheckInputs(FChangeCheckInputs& OutInputs) const
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_MonitorForChanges);
+	check(IsInGameThread());
+
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	TArray<UMeshComponent*, TInlineAllocator<32>> CurrentMeshComponents;
+	GetOwner()->GetComponents<UMeshComponent>(CurrentMeshComponents);
+	OutInputs.NumMeshComponents = CurrentMeshComponents.Num();
+
+	const auto& Identity = FSimpleSurfaceMeshIdentity::Get();
+	for (const auto Component : CurrentMeshComponents)
+	{
+		OutInputs.bThreadSafe &= Identity.IsThreadSafe(*Component);
+		for (int32 i = 0; i < Component->GetNumMaterials(); i++)
+		{
+			OutInputs.Materials.Add(Component->GetMaterial(i));
+		}
+	}
+
+	OutInputs.CatalogComponents.Reserve(MeshCatalog.Entries.Num());
+	OutInputs.CatalogNumSlots.Reserve(MeshCatalog.Entries.Num());
+	for (const auto& Entry : MeshCatalog.Entries)
+	{
+		const auto MeshComponent = Entry.Component.Get();
+		OutInputs.CatalogComponents.Add(MeshComponent);
+		OutInputs.CatalogNumSlots.Add(MeshComponent ? MeshComponent->GetNumMaterials() : 0);
+		OutInputs.bThreadSafe &= !MeshComponent || Identity.IsThreadSafe(*MeshComponent);
+	}
+
+	for (const auto& VariedInstances : VariedInstanceCounts)
+	{
+		const auto InstancedMeshComponent = VariedInstances.Key.Get();
+		if (InstancedMeshComponent && InstancedMeshComponent->GetInstanceCount() != VariedInstances.Value)
+		{
+			OutInputs.bInstanceCountChanged = true;
+			break;
+		}
+	}
+
+	OutInputs.CustomDataMaterial = USimpleSurfaceSubsystem::GetCustomDataMaterial();
+}
+
+bool USimpleSurfaceComponent::DetectChanges(const FChangeCheckInputs& Inputs) const
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_MonitorForChanges);
+
+	// Has the number of mesh components changed?
+	if (Inputs.NumMeshComponents != CapturedMeshComponentCount)
+	{
+		return true;
+	}
+
+	// Have any of the components' meshes changed?
+	if (MeshCatalog.HasMeshChanged(Inputs.CatalogComponents, Inputs.CatalogNumSlots))
+	{
+		return true;
+	}
+
+	// Have instances been added to or removed from an instanced mesh with variation?
+	if (Inputs.bInstanceCountChanged)
+	{
+		return true;
+	}
+
+	// Are there any materials in use that aren't SimpleSurface?
+	// Mesh and slot count changes were caught above; this catches materials assigned to slots by someone else.
+	return Algo::AnyOf(Inputs.Materials, [this, &Inputs](const UMaterialInterface* Material)
+	{
+		return Material && !Material->IsA<UMaterialInstanceDynamic>() && Material != Inputs.CustomDataMaterial && Material != BakedMaterial;
+	});
 }
 
 void USimpleSurfaceComponent::OnRegister()
 {
+	INC_DWORD_STAT(STAT_SimpleSurface_Components);
+
+	// Texture overrides are only loaded for registered surfaces, rather than whenever their owners load.
+	UpdatePresetSubscription();
+	UpdateTextureRequest();
 	InitializeSharedMID();
+	bHandedOffCatalog = false;
 
 	if (!GetOwner())
 	{
 		return;
 	}
 
-	// Initialize the mesh catalog.
-	UpdateMeshCatalog();
+	// A duplicated or pasted actor's catalog still refers to the original's components.
+	MeshCatalog.RemapToActor(*GetOwner());
 
-	// Calling ApplyAll() here ensures that all UMeshComponents on this actor that may already be using a SimpleSurfaceMaterial are using *this* component's instance of the SimpleSurfaceMaterial.
-	// This is important following an actor duplication; we can't the duplicate's UMeshComponents referencing the original's SimpleSurfaceMaterial. 
-	ApplyAll();
+	if (bHasAppliedSurface && !UsesCustomPrimitiveData() && !InstanceVariation.IsEnabled())
+	{
+		// Registering again, e.g. for every property edit while the owner's construction script reruns; most meshes
+		// still show this surface and don't need capturing or assigning again.
+		ApplyToChangedMeshes();
+	}
+	else
+	{
+		// Initialize the mesh catalog, unless it was captured ahead of registering.
+		if (!bIsCatalogPrepared)
+		{
+			UpdateMeshCatalog();
+		}
+		bIsCatalogPrepared = false;
+
+		// Calling ApplyAll() here ensures that all UMeshComponents on this actor that may already be using a SimpleSurfaceMaterial are using *this* component's instance of the SimpleSurfaceMaterial.
+		// This is important following an actor duplication; we can't the duplicate's UMeshComponents referencing the original's SimpleSurfaceMaterial. 
+		ApplyAll();
+	}
+	bHasAppliedSurface = true;
 	
 	Super::OnRegister();
+
+	UpdateChangeDetection();
+	UpdateDistanceLOD();
+}
+
+void USimpleSurfaceComponent::OnUnregister()
+{
+	DEC_DWORD_STAT(STAT_SimpleSurface_Components);
+
+	FSimpleSurfaceChangeRouter::Get().RemoveListener(*this);
+	ClearDynamicMeshSubscriptions();
+	if (auto OldPreset = SubscribedPreset.Get())
+	{
+		OldPreset->OnPresetChanged().Remove(PresetChangedHandle);
+	}
+	SubscribedPreset.Reset();
+	PresetChangedHandle.Reset();
+	ReleasePooledMaterial();
+	FlushMaterialRestore();
+
+	if (auto Subsystem = GetSurfaceSubsystem())
+	{
+		Subsystem->StopMonitoring(*this);
+		Subsystem->StopDistanceLOD(*this);
+		if (!RequestedTexture.IsNull())
+		{
+			Subsystem->ReleaseTexture(RequestedTexture);
+		}
+	}
+	RequestedTexture.Reset();
+
+	if (PendingChangesTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PendingChangesTickerHandle);
+		PendingChangesTickerHandle.Reset();
+	}
+	bSurfaceDirty = false;
+	bParametersDirty = false;
+
+	Super::OnUnregister();
+}
+
+#if WITH_EDITOR
+void USimpleSurfaceComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, ChangeDetection))
+	{
+		UpdateChangeDetection();
+	}
+
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, bUseDistanceLOD))
+	{
+		UpdateDistanceLOD();
+	}
+
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, InstanceVariation))
+	{
+		SetParameter_InstanceVariation(InstanceVariation);
+	}
+
+	// Values edited on a component using a preset override the preset's, as if set through their setters.
+	static const TMap<FName, ESimpleSurfacePresetField> PresetFields = {
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, Color), ESimpleSurfacePresetField::Color },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, Glow), ESimpleSurfacePresetField::Glow },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, ShininessRoughness), ESimpleSurfacePresetField::ShininessRoughness },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, WaxinessMetalness), ESimpleSurfacePresetField::WaxinessMetalness },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, TextureIntensity), ESimpleSurfacePresetField::TextureIntensity },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, TextureScale), ESimpleSurfacePresetField::TextureScale },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, Texture), ESimpleSurfacePresetField::Texture },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, ShowGrid), ESimpleSurfacePresetField::ShowGrid },
+		{ GET_MEMBER_NAME_CHECKED(USimpleSurfaceComponent, GridParams), ESimpleSurfacePresetField::GridParams },
+	};
+	if (const auto Field = PresetFields.Find(PropertyChangedEvent.GetMemberPropertyName()))
+	{
+		OverridePreset(*Field);
+	}
+
+	// Monitored and event-driven components may not be checked again for a while; apply details panel edits right away.
+	if (IsRegistered())
+	{
+		ApplyParametersToMaterial();
+	}
+}
+
+void USimpleSurfaceComponent::PostEditUndo()
+{
+	Super::PostEditUndo();
+	NotifyMeshComponentsChanged();
+}
+#endif
+
+void USimpleSurfaceComponent::NotifyMeshComponentsChanged()
+{
+	// Ignore the notifications raised by our own material assignments.
+	if (bIsApplyingSurface || ChangeDetection != ESimpleSurfaceChangeDetection::EventDriven)
+	{
+		return;
+	}
+
+	if (bSurfaceDirty)
+	{
+		return;
+	}
+	bSurfaceDirty = true;
+
+	// Notifications tend to arrive in bursts, e.g. one per material slot; process them all at once later in the frame.
+	if (auto Subsystem = GetSurfaceSubsystem())
+	{
+		Subsystem->QueueChangedComponent(*this);
+	}
+	else if (!PendingChangesTickerHandle.IsValid())
+	{
+		PendingChangesTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+		{
+			PendingChangesTickerHandle.Reset();
+			ProcessPendingChanges();
+			return false;
+		}));
+	}
+}
+
+bool USimpleSurfaceComponent::ProcessPendingChanges()
+{
+	if (!bSurfaceDirty)
+	{
+		return false;
+	}
+	bSurfaceDirty = false;
+
+	if (!IsRegistered() || !IsActive())
+	{
+		return false;
+	}
+
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_ProcessPendingChanges);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	ON_SCOPE_EXIT { MonitoringCycles += FPlatformTime::Cycles64() - StartCycles; };
+	SimpleSurfaceStats::CountReapply();
+
+	UE_LOG(LogSimpleSurface, Verbose, TEXT("%hs: Change in mesh components or materials reported.  Recapturing materials and re-applying surface."), FUNC_SIGNATURE)
+
+	UpdateMeshCatalog();
+	ApplyAll();
+	RefreshDynamicMeshSubscriptions();
+	return true;
+}
+
+void USimpleSurfaceComponent::UpdateChangeDetection()
+{
+	const bool bEventDriven = ChangeDetection == ESimpleSurfaceChangeDetection::EventDriven;
+	const bool bPolling = !bEventDriven && IsActive();
+
+	// Polling components are checked by the subsystem, in one batched loop, when it's available.
+	auto Subsystem = USimpleSurfaceSubsystem::IsCentralMonitoringEnabled() ? GetSurfaceSubsystem() : nullptr;
+	if (Subsystem && bPolling && IsRegistered())
+	{
+		Subsystem->StartMonitoring(*this);
+		SetComponentTickEnabled(false);
+	}
+	else
+	{
+		if (auto CurrentSubsystem = GetSurfaceSubsystem())
+		{
+			CurrentSubsystem->StopMonitoring(*this);
+		}
+		SetComponentTickEnabled(bPolling);
+	}
+
+	if (bEventDriven && IsRegistered())
+	{
+		FSimpleSurfaceChangeRouter::Get().AddListener(*this);
+		RefreshDynamicMeshSubscriptions();
+	}
+	else
+	{
+		FSimpleSurfaceChangeRouter::Get().RemoveListener(*this);
+		ClearDynamicMeshSubscriptions();
+	}
+}
+
+void USimpleSurfaceComponent::RefreshDynamicMeshSubscriptions()
+{
+	ClearDynamicMeshSubscriptions();
+
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	TArray<UDynamicMeshComponent*, TInlineAllocator<8>> DynamicMeshComponents;
+	GetOwner()->GetComponents<UDynamicMeshComponent>(DynamicMeshComponents);
+	for (const auto DynamicMeshComponent : DynamicMeshComponents)
+	{
+		if (const auto DynamicMesh = DynamicMeshComponent->GetDynamicMesh())
+		{
+			DynamicMeshSubscriptions.Emplace(DynamicMesh, DynamicMesh->OnMeshChanged().AddUObject(this, &USimpleSurfaceComponent::HandleDynamicMeshChanged));
+		}
+	}
+}
+
+void USimpleSurfaceComponent::ClearDynamicMeshSubscriptions()
+{
+	for (const auto& Subscription : DynamicMeshSubscriptions)
+	{
+		if (const auto DynamicMesh = Subscription.Key.Get())
+		{
+			DynamicMesh->OnMeshChanged().Remove(Subscription.Value);
+		}
+	}
+	DynamicMeshSubscriptions.Reset();
+}
+
+void USimpleSurfaceComponent::HandleDynamicMeshChanged(UDynamicMesh* Mesh, FDynamicMeshChangeInfo ChangeInfo)
+{
+	NotifyMeshComponentsChanged();
 }
 
 void USimpleSurfaceComponent::TickComponent(float DeltaTime, ELevelTick TickType,
@@ -565,9 +1409,18 @@ void USimpleSurfaceComponent::TickComponent(float DeltaTime, ELevelTick TickType
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	PollForChanges();
+}
+
+bool USimpleSurfaceComponent::PollForChanges(const TOptional<bool> bChangeDetected)
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_PollForChanges);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	ON_SCOPE_EXIT { MonitoringCycles += FPlatformTime::Cycles64() - StartCycles; };
+
 	ApplyParametersToMaterial();
 	
-	if (MonitorForChanges())
+	if (bChangeDetected.IsSet() ? bChangeDetected.GetValue() : MonitorForChanges())
 	{
 		UE_LOG(LogSimpleSurface, Verbose, TEXT("%hs: Change in mesh components or materials detected.  Recapturing materials and re-applying surface."), FUNC_SIGNATURE)
 
@@ -576,5 +1429,15 @@ void USimpleSurfaceComponent::TickComponent(float DeltaTime, ELevelTick TickType
 
 		// Re-apply SimpleSurface to all material slots.
 		ApplyAll();
+		SimpleSurfaceStats::CountReapply();
+
+		// Event-driven components are polled when a change may have gone unnotified, e.g. a dynamic mesh component was added.
+		if (ChangeDetection == ESimpleSurfaceChangeDetection::EventDriven)
+		{
+			RefreshDynamicMeshSubscriptions();
+		}
+		return true;
 	}
+
+	return false;
 }
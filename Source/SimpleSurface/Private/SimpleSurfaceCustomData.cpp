@@ -0,0 +1,146 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceCustomData.h"
+
+#include "SimpleSurfaceStats.h"
+#include "SimpleSurfaceTypes.h"
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/PrimitiveComponent.h"
+
+namespace SimpleSurfaceCustomData
+{
+	FPackedParameters Pack(const FSimpleSurfaceParameters& Parameters)
+	{
+		FPackedParameters Packed;
+		Packed.SetNumZeroed(Num);
+
+		const FLinearColor LinearColor(Parameters.Color);
+		Packed[Color + 0] = LinearColor.R;
+		Packed[Color + 1] = LinearColor.G;
+		Packed[Color + 2] = LinearColor.B;
+		Packed[Glow] = Parameters.Glow;
+		Packed[ShininessRoughness] = Parameters.ShininessRoughness;
+		Packed[WaxinessMetalness] = Parameters.WaxinessMetalness;
+		Packed[TextureIntensity] = Parameters.TextureIntensity;
+		Packed[TextureScale] = Parameters.TextureScale;
+		Packed[ShowGrid] = Parameters.ShowGrid;
+		Packed[GridSize] = Parameters.GridParams.GridSize;
+		Packed[SubGridDivisions] = Parameters.GridParams.SubGridDivisions;
+		Packed[ObjectAligned] = Parameters.GridParams.bIsObjectAligned ? 1.0f : 0.0f;
+
+		return Packed;
+	}
+
+	void Write(UPrimitiveComponent& Component, const FPackedParameters& Packed)
+	{
+		SIMPLESURFACE_SCOPE(STAT_SimpleSurface_WriteCustomData);
+
+		check(Packed.Num() == Num)
+
+		const TArray<float>& Current = Component.GetCustomPrimitiveData().Data;
+
+		// Write in groups of four, the granularity the renderer stores custom data at, and only the groups that changed.
+		for (int32 Offset = 0; Offset < Num; Offset += 4)
+		{
+			bool bGroupChanged = false;
+			for (int32 i = Offset; i < Offset + 4; ++i)
+			{
+				bGroupChanged |= !Current.IsValidIndex(i) || Current[i] != Packed[i];
+			}
+
+			if (bGroupChanged)
+			{
+				Component.SetCustomPrimitiveDataVector4(Offset, FVector4(Packed[Offset], Packed[Offset + 1], Packed[Offset + 2], Packed[Offset + 3]));
+			}
+		}
+	}
+
+	void Clear(UPrimitiveComponent& Component)
+	{
+		const TArray<float>& Defaults = Component.GetDefaultCustomPrimitiveData().Data;
+		const TArray<float>& Current = Component.GetCustomPrimitiveData().Data;
+
+		for (int32 Offset = 0; Offset < Num && Current.IsValidIndex(Offset); Offset += 4)
+		{
+			FVector4 Value;
+			for (int32 i = 0; i < 4; ++i)
+			{
+				Value[i] = Defaults.IsValidIndex(Offset + i) ? Defaults[Offset + i] : 0.0f;
+			}
+			Component.SetCustomPrimitiveDataVector4(Offset, Value);
+		}
+	}
+
+	int32 WriteInstances(UInstancedStaticMeshComponent& Component, const FSimpleSurfaceParameters& Base, const FSimpleSurfaceInstanceVariation& Variation)
+	{
+		SIMPLESURFACE_SCOPE(STAT_SimpleSurface_WriteCustomData);
+
+		const int32 NumInstances = Component.GetInstanceCount();
+		if (Component.NumCustomDataFloats != Num)
+		{
+			Component.SetNumCustomDataFloats(Num);
+		}
+
+		// Compute every instance's data up front; instances are independent, and there may be tens of thousands of them.
+		TArray<float> InstanceData;
+		InstanceData.SetNumUninitialized(NumInstances * Num);
+		ParallelFor(NumInstances, [&](const int32 InstanceIndex)
+		{
+			const auto Packed = Pack(Variation.Vary(Base, InstanceIndex));
+			FMemory::Memcpy(&InstanceData[InstanceIndex * Num], Packed.GetData(), Num * sizeof(float));
+		}, NumInstances < 1024 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+		// The recreated render state picks up the whole buffer; writing instances one at a time would track each.
+		const TArray<float>& Current = Component.PerInstanceSMCustomData;
+		if (Current.Num() != InstanceData.Num() || FMemory::Memcmp(Current.GetData(), InstanceData.GetData(), InstanceData.Num() * sizeof(float)) != 0)
+		{
+			Component.PerInstanceSMCustomData = MoveTemp(InstanceData);
+			Component.MarkRenderStateDirty();
+		}
+
+		return NumInstances;
+	}
+
+	FInstanceData CaptureInstances(const UInstancedStaticMeshComponent& Component)
+	{
+		FInstanceData Captured;
+		if (Component.NumCustomDataFloats != Num)
+		{
+			Captured.NumFloats = Component.NumCustomDataFloats;
+			Captured.Data = Component.PerInstanceSMCustomData;
+		}
+		else if (const auto Archetype = Cast<UInstancedStaticMeshComponent>(Component.GetArchetype()))
+		{
+			Captured.NumFloats = Archetype->NumCustomDataFloats;
+		}
+		return Captured;
+	}
+
+	void ClearInstances(UInstancedStaticMeshComponent& Component, const FInstanceData& DataBeforeWrite)
+	{
+		if (Component.NumCustomDataFloats != DataBeforeWrite.NumFloats)
+		{
+			Component.SetNumCustomDataFloats(DataBeforeWrite.NumFloats);
+		}
+
+		TArray<float> Data = DataBeforeWrite.Data;
+		Data.SetNumZeroed(Component.GetInstanceCount() * DataBeforeWrite.NumFloats);
+		if (Component.PerInstanceSMCustomData != Data)
+		{
+			Component.PerInstanceSMCustomData = MoveTemp(Data);
+			Component.MarkRenderStateDirty();
+		}
+	}
+}
@@ -0,0 +1,603 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceMeshCatalog.h"
+
+#include "SimpleSurfaceMeshIdentity.h"
+#include "Algo/Compare.h"
+#include "Algo/NoneOf.h"
+#include "Algo/Reverse.h"
+#include "Components/MeshComponent.h"
+#include "GameFramework/Actor.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Serialization/CustomVersion.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SimpleSurfaceCatalogVersion
+{
+	enum Type : int32
+	{
+		BeforeCustomVersion = 0,
+
+		/** Material paths are stored once per catalog, and slots and index paths as packed integers. */
+		CompactCatalog,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	const FGuid Guid(0x2B7AEB44, 0x0F524758, 0xA8A7F233, 0x084F8D6A);
+
+	FCustomVersionRegistration Registration(Guid, LatestVersion, TEXT("SimpleSurfaceCatalogVersion"));
+}
+
+FSimpleSurfaceMeshCatalog::FSimpleSurfaceMeshCatalog()
+{
+	ExcludedMaterialClasses.Add(UMaterialInstanceDynamic::StaticClass());
+}
+
+void FSimpleSurfaceMeshCatalog::Capture(TConstArrayView<UMeshComponent*> MeshComponents, TConstArrayView<const UMaterialInterface*> ExcludedMaterials)
+{
+	// Rebuild into fresh arrays, so entries whose slot counts changed don't leave gaps behind.
+	FSimpleSurfaceMeshCatalog Captured;
+	Captured.ExcludedMaterialClasses = ExcludedMaterialClasses;
+	Captured.Entries.Reserve(FMath::Max(Entries.Num(), MeshComponents.Num()));
+	Captured.Materials.Reserve(Materials.Num());
+
+	TBitArray<TInlineAllocator<4>> EntryConsumed(false, Entries.Num());
+
+	// An actor's catalog is small enough to scan; a world's, e.g. one kept by SimpleSurface rules, isn't.
+	constexpr int32 MaxScannedEntries = 32;
+	TMap<FSoftObjectPath, int32> EntryIndexes;
+	if (Entries.Num() > MaxScannedEntries)
+	{
+		EntryIndexes.Reserve(Entries.Num());
+		for (int32 i = 0; i < Entries.Num(); ++i)
+		{
+			EntryIndexes.Add(Entries[i].Component.ToSoftObjectPath(), i);
+		}
+	}
+
+	for (const auto MeshComponent : MeshComponents)
+	{
+		if (!MeshComponent)
+		{
+			continue;
+		}
+
+		const FSimpleSurfaceMeshCatalogEntry* Previous = nullptr;
+		if (EntryIndexes.IsEmpty())
+		{
+			for (int32 i = 0; i < Entries.Num(); ++i)
+			{
+				if (!EntryConsumed[i] && Entries[i].Component == MeshComponent)
+				{
+					Previous = &Entries[i];
+					EntryConsumed[i] = true;
+					break;
+				}
+			}
+		}
+		else if (const int32* Index = EntryIndexes.Find(FSoftObjectPath(MeshComponent)); Index && !EntryConsumed[*Index])
+		{
+			Previous = &Entries[*Index];
+			EntryConsumed[*Index] = true;
+		}
+
+		// Pooled SimpleSurface materials are never saved, so after loading, the slots they were assigned to have no override
+		// and present the mesh's own material.  That mustn't overwrite what was captured in an earlier session, and within
+		// a session it only should if the mesh itself changed.
+		const uint32 NewMeshHash = GetMeshHash(MeshComponent);
+		const bool bKeepUnoverriddenSlots = Previous && (!Previous->bCapturedThisSession || NewMeshHash == Previous->MeshHash);
+
+		auto& Entry = Captured.Entries.AddDefaulted_GetRef();
+		Entry.Component = MeshComponent;
+		Entry.MeshHash = NewMeshHash;
+		Entry.bCapturedThisSession = true;
+
+		const auto IndexPath = GetIndexPath(*MeshComponent);
+		Entry.FirstPathIndex = Captured.IndexPaths.Num();
+		Entry.PathLength = IndexPath.Num();
+		Captured.IndexPaths.Append(IndexPath);
+
+		// Take care to update the slots one by one, don't just copy the materials; because we don't want to capture
+		// excluded materials.
+		const int32 NumMaterials = MeshComponent->GetNumMaterials();
+		Entry.FirstSlot = Captured.Materials.Num();
+		Entry.NumSlots = NumMaterials;
+		if (Previous)
+		{
+			const auto PreviousMaterials = GetMaterials(*Previous);
+			Captured.Materials.Append(PreviousMaterials.Left(NumMaterials));
+		}
+		Captured.Materials.SetNum(Entry.FirstSlot + NumMaterials);
+
+		for (int32 i = 0; i < NumMaterials; ++i)
+		{
+			auto& CapturedMaterial = Captured.Materials[Entry.FirstSlot + i];
+			const bool bIsOverridden = MeshComponent->OverrideMaterials.IsValidIndex(i) && MeshComponent->OverrideMaterials[i];
+			if (bKeepUnoverriddenSlots && !bIsOverridden && !CapturedMaterial.IsNull())
+			{
+				continue;
+			}
+
+			auto Material = MeshComponent->GetMaterial(i);
+			if (Material && !ExcludedMaterials.Contains(Material) && !ExcludedMaterialClasses.Contains(Material->GetClass()))
+			{
+				CapturedMaterial = Material;
+			}
+		}
+	}
+
+	// Keep entries for components that left the actor but still exist, so their materials can still be restored.
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const auto& Entry = Entries[i];
+		if (!EntryConsumed[i] && Entry.Component.Get())
+		{
+			Captured.AddEntry(Entry.Component, Entry.MeshHash, GetMaterials(Entry), GetIndexPath(Entry));
+			Captured.Entries.Last().bCapturedThisSession = Entry.bCapturedThisSession;
+		}
+	}
+
+	*this = MoveTemp(Captured);
+}
+
+void FSimpleSurfaceMeshCatalog::AddEntry(const TSoftObjectPtr<UMeshComponent>& Component, const uint32 MeshHash,
+	TConstArrayView<TSoftObjectPtr<UMaterialInterface>> EntryMaterials, TConstArrayView<int32> IndexPath)
+{
+	auto& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Component = Component;
+	Entry.MeshHash = MeshHash;
+	Entry.FirstSlot = Materials.Num();
+	Entry.NumSlots = EntryMaterials.Num();
+	Entry.FirstPathIndex = IndexPaths.Num();
+	Entry.PathLength = IndexPath.Num();
+	Materials.Append(EntryMaterials);
+	IndexPaths.Append(IndexPath);
+}
+
+void FSimpleSurfaceMeshCatalog::Merge(const FSimpleSurfaceMeshCatalog& Other)
+{
+	TSet<FSoftObjectPath> CapturedComponents;
+	CapturedComponents.Reserve(Entries.Num());
+	for (const auto& Entry : Entries)
+	{
+		CapturedComponents.Add(Entry.Component.ToSoftObjectPath());
+	}
+
+	for (const auto& Entry : Other.Entries)
+	{
+		if (!CapturedComponents.Contains(Entry.Component.ToSoftObjectPath()))
+		{
+			AddEntry(Entry.Component, Entry.MeshHash, Other.GetMaterials(Entry), Other.GetIndexPath(Entry));
+			Entries.Last().bCapturedThisSession = Entry.bCapturedThisSession;
+		}
+	}
+}
+
+void FSimpleSurfaceMeshCatalog::GetChangedComponents(TConstArrayView<UMeshComponent*> MeshComponents,
+	TArray<UMeshComponent*, TInlineAllocator<32>>& OutChanged) const
+{
+	TMap<const UMeshComponent*, const FSimpleSurfaceMeshCatalogEntry*> EntriesByComponent;
+	EntriesByComponent.Reserve(Entries.Num());
+	for (const auto& Entry : Entries)
+	{
+		if (const auto MeshComponent = Entry.Component.Get(); MeshComponent && Entry.bCapturedThisSession)
+		{
+			EntriesByComponent.Add(MeshComponent, &Entry);
+		}
+	}
+
+	for (const auto MeshComponent : MeshComponents)
+	{
+		const auto* Entry = MeshComponent ? EntriesByComponent.FindRef(MeshComponent) : nullptr;
+		if (MeshComponent && (!Entry || Entry->NumSlots != MeshComponent->GetNumMaterials() || Entry->MeshHash != GetMeshHash(MeshComponent)))
+		{
+			OutChanged.Add(MeshComponent);
+		}
+	}
+}
+
+bool FSimpleSurfaceMeshCatalog::RemapToActor(const AActor& Actor)
+{
+	auto IsForeign = [&Actor](const FSimpleSurfaceMeshCatalogEntry& Entry)
+	{
+		const auto MeshComponent = Entry.Component.Get();
+		return !MeshComponent || MeshComponent->GetOwner() != &Actor;
+	};
+
+	// Most catalogs only refer to their actor's own components.
+	if (Algo::NoneOf(Entries, IsForeign))
+	{
+		return false;
+	}
+
+	// Index the actor's components once for all entries.  Index paths are only needed for entries whose component was
+	// renamed since, so they're only computed then.
+	TArray<UMeshComponent*, TInlineAllocator<32>> MeshComponents;
+	Actor.GetComponents<UMeshComponent>(MeshComponents);
+
+	TMap<FName, UMeshComponent*> ComponentsByName;
+	ComponentsByName.Reserve(MeshComponents.Num());
+	for (const auto MeshComponent : MeshComponents)
+	{
+		ComponentsByName.Add(MeshComponent->GetFName(), MeshComponent);
+	}
+
+	TArray<TArray<int32, TInlineAllocator<8>>> ComponentPaths;
+
+	// Each component is remapped to at most once, and not at all if an entry already refers to it.
+	TSet<const UMeshComponent*> ClaimedComponents;
+	for (const auto& Entry : Entries)
+	{
+		if (!IsForeign(Entry))
+		{
+			ClaimedComponents.Add(Entry.Component.Get());
+		}
+	}
+
+	bool bRemapped = false;
+	for (auto& Entry : Entries)
+	{
+		if (!IsForeign(Entry))
+		{
+			continue;
+		}
+
+		// Components are subobjects of their actor, so a component's name is the last element of its path.
+		const FString SubPath = Entry.Component.ToSoftObjectPath().GetSubPathString();
+		int32 NameStart = INDEX_NONE;
+		SubPath.FindLastChar(TEXT('.'), NameStart);
+		const FName ComponentName(FStringView(SubPath).RightChop(NameStart + 1));
+
+		UMeshComponent* Remapped = ComponentsByName.FindRef(ComponentName);
+		if (Remapped && ClaimedComponents.Contains(Remapped))
+		{
+			Remapped = nullptr;
+		}
+
+		if (!Remapped && Entry.PathLength > 0)
+		{
+			if (ComponentPaths.IsEmpty())
+			{
+				ComponentPaths.Reserve(MeshComponents.Num());
+				for (const auto MeshComponent : MeshComponents)
+				{
+					ComponentPaths.Add(GetIndexPath(*MeshComponent));
+				}
+			}
+
+			const auto EntryPath = GetIndexPath(Entry);
+			for (int32 Index = 0; Index < MeshComponents.Num(); ++Index)
+			{
+				if (!ClaimedComponents.Contains(MeshComponents[Index]) && Algo::Compare(ComponentPaths[Index], EntryPath))
+				{
+					Remapped = MeshComponents[Index];
+					break;
+				}
+			}
+		}
+
+		if (Remapped)
+		{
+			// What the entry captured is from another session, as far as this component is concerned.
+			Entry.Component = Remapped;
+			Entry.bCapturedThisSession = false;
+			ClaimedComponents.Add(Remapped);
+			bRemapped = true;
+		}
+	}
+
+	// Whatever is left refers to another actor's components, whose materials aren't this actor's to restore.
+	const int32 NumEntries = Entries.Num();
+	RemoveEntries(IsForeign);
+	return bRemapped || Entries.Num() != NumEntries;
+}
+
+void FSimpleSurfaceMeshCatalog::RemoveStaleEntries()
+{
+	RemoveEntries([](const FSimpleSurfaceMeshCatalogEntry& Entry) { return Entry.Component.Get() == nullptr; });
+}
+
+void FSimpleSurfaceMeshCatalog::RemoveEntries(TFunctionRef<bool(const FSimpleSurfaceMeshCatalogEntry&)> Predicate)
+{
+	if (Algo::NoneOf(Entries, Predicate))
+	{
+		return;
+	}
+
+	FSimpleSurfaceMeshCatalog Remaining;
+	Remaining.ExcludedMaterialClasses = ExcludedMaterialClasses;
+	for (const auto& Entry : Entries)
+	{
+		if (!Predicate(Entry))
+		{
+			Remaining.AddEntry(Entry.Component, Entry.MeshHash, GetMaterials(Entry), GetIndexPath(Entry));
+			Remaining.Entries.Last().bCapturedThisSession = Entry.bCapturedThisSession;
+		}
+	}
+
+	*this = MoveTemp(Remaining);
+}
+
+TConstArrayView<TSoftObjectPtr<UMaterialInterface>> FSimpleSurfaceMeshCatalog::GetMaterials(const FSimpleSurfaceMeshCatalogEntry& Entry) const
+{
+	// Guard against malformed ranges in saved data.
+	if (Entry.FirstSlot < 0 || Entry.NumSlots < 0 || Entry.FirstSlot + Entry.NumSlots > Materials.Num())
+	{
+		return {};
+	}
+	return TConstArrayView<TSoftObjectPtr<UMaterialInterface>>(Materials).Slice(Entry.FirstSlot, Entry.NumSlots);
+}
+
+TConstArrayView<int32> FSimpleSurfaceMeshCatalog::GetIndexPath(const FSimpleSurfaceMeshCatalogEntry& Entry) const
+{
+	if (Entry.FirstPathIndex < 0 || Entry.PathLength < 0 || Entry.FirstPathIndex + Entry.PathLength > IndexPaths.Num())
+	{
+		return {};
+	}
+	return TConstArrayView<int32>(IndexPaths).Slice(Entry.FirstPathIndex, Entry.PathLength);
+}
+
+void FSimpleSurfaceMeshCatalog::ApplyMaterials(const FSimpleSurfaceMeshCatalogEntry& Entry, UMeshComponent& MeshComponent) const
+{
+	const auto EntryMaterials = GetMaterials(Entry);
+
+	TArray<UMaterialInterface*, TInlineAllocator<16>> Materials;
+	Materials.SetNumZeroed(FMath::Max(EntryMaterials.Num(), MeshComponent.GetNumMaterials()));
+	for (int32 i = 0; i < EntryMaterials.Num(); ++i)
+	{
+		Materials[i] = EntryMaterials[i].Get();
+	}
+
+	AssignMaterials(MeshComponent, Materials);
+}
+
+int32 FSimpleSurfaceMeshCatalog::AssignMaterials(UMeshComponent& MeshComponent, TConstArrayView<UMaterialInterface*> Materials, const bool bAlwaysMarkDirty)
+{
+	// Find the slots that differ first, so unchanged components aren't modified or have their render state dirtied at all.
+	TArray<int32, TInlineAllocator<16>> ChangedSlots;
+	for (int32 i = 0; i < Materials.Num(); ++i)
+	{
+		const bool bDiffers = Materials[i]
+			? MeshComponent.GetMaterial(i) != Materials[i]
+			: MeshComponent.OverrideMaterials.IsValidIndex(i) && MeshComponent.OverrideMaterials[i] != nullptr;
+		if (bDiffers)
+		{
+			ChangedSlots.Add(i);
+		}
+	}
+
+	if (ChangedSlots.IsEmpty())
+	{
+		return 0;
+	}
+
+	// Inside a transaction, recording the component once captures every slot for undo.
+	MeshComponent.Modify(bAlwaysMarkDirty);
+
+	// SetMaterial only flags the render state dirty; the proxy is recreated once, at the end of the frame.
+	for (const int32 Slot : ChangedSlots)
+	{
+		MeshComponent.SetMaterial(Slot, Materials[Slot]);
+	}
+	return ChangedSlots.Num();
+}
+
+void FSimpleSurfaceMeshCatalog::CollectUnloadedMaterials(TArray<FSoftObjectPath>& OutPaths) const
+{
+	for (const auto& Entry : Entries)
+	{
+		if (!Entry.Component.Get())
+		{
+			continue;
+		}
+
+		for (const auto& SoftMaterialPtr : GetMaterials(Entry))
+		{
+			if (!SoftMaterialPtr.IsNull() && !SoftMaterialPtr.IsValid())
+			{
+				OutPaths.AddUnique(SoftMaterialPtr.ToSoftObjectPath());
+			}
+		}
+	}
+}
+
+bool FSimpleSurfaceMeshCatalog::HasMeshChanged() const
+{
+	for (const auto& Entry : Entries)
+	{
+		const auto MeshComponent = Entry.Component.Get();
+		if (!MeshComponent || Entry.NumSlots != MeshComponent->GetNumMaterials() || Entry.MeshHash != GetMeshHash(MeshComponent))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FSimpleSurfaceMeshCatalog::HasMeshChanged(TConstArrayView<UMeshComponent*> EntryComponents, TConstArrayView<int32> EntryNumSlots) const
+{
+	check(EntryComponents.Num() == Entries.Num() && EntryNumSlots.Num() == Entries.Num());
+	for (int32 i = 0; i < Entries.Num(); i++)
+	{
+		const auto MeshComponent = EntryComponents[i];
+		if (!MeshComponent || Entries[i].NumSlots != EntryNumSlots[i] || Entries[i].MeshHash != GetMeshHash(MeshComponent))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+SIZE_T FSimpleSurfaceMeshCatalog::GetAllocatedSize() const
+{
+	return Entries.GetAllocatedSize() + Materials.GetAllocatedSize() + IndexPaths.GetAllocatedSize() + ExcludedMaterialClasses.GetAllocatedSize();
+}
+
+bool FSimpleSurfaceMeshCatalog::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(SimpleSurfaceCatalogVersion::Guid);
+
+	// Transactions, duplication and text formats keep using tagged properties, as do catalogs saved before.
+	if (!Ar.IsPersistent() || Ar.IsTextFormat()
+		|| (Ar.IsLoading() && Ar.CustomVer(SimpleSurfaceCatalogVersion::Guid) < SimpleSurfaceCatalogVersion::CompactCatalog))
+	{
+		return false;
+	}
+
+	// Nearly every catalog excludes only the default classes.
+	bool bHasDefaultExclusions = Ar.IsSaving() && ExcludedMaterialClasses == FSimpleSurfaceMeshCatalog().ExcludedMaterialClasses;
+	Ar << bHasDefaultExclusions;
+	if (bHasDefaultExclusions)
+	{
+		ExcludedMaterialClasses = FSimpleSurfaceMeshCatalog().ExcludedMaterialClasses;
+	}
+	else
+	{
+		Ar << ExcludedMaterialClasses;
+	}
+
+	// Slots refer to materials by their index in the table, plus one; zero is no material.
+	TArray<FSoftObjectPath> MaterialTable;
+	TArray<uint32> SlotIndexes;
+	if (Ar.IsSaving())
+	{
+		TMap<FSoftObjectPath, uint32> TableIndexes;
+		SlotIndexes.Reserve(Materials.Num());
+		for (const auto& Material : Materials)
+		{
+			if (Material.IsNull())
+			{
+				SlotIndexes.Add(0);
+				continue;
+			}
+
+			const FSoftObjectPath MaterialPath = Material.ToSoftObjectPath();
+			if (const uint32* TableIndex = TableIndexes.Find(MaterialPath))
+			{
+				SlotIndexes.Add(*TableIndex);
+			}
+			else
+			{
+				MaterialTable.Add(MaterialPath);
+				SlotIndexes.Add(TableIndexes.Add(MaterialPath, static_cast<uint32>(MaterialTable.Num())));
+			}
+		}
+	}
+	Ar << MaterialTable;
+
+	int32 NumEntries = Entries.Num();
+	Ar << NumEntries;
+	if (Ar.IsLoading())
+	{
+		if (NumEntries < 0)
+		{
+			Ar.SetError();
+			return true;
+		}
+
+		Entries.Reset(NumEntries);
+		Materials.Reset();
+		IndexPaths.Reset();
+	}
+
+	for (int32 i = 0; i < NumEntries && !Ar.IsError(); ++i)
+	{
+		auto& Entry = Ar.IsLoading() ? Entries.AddDefaulted_GetRef() : Entries[i];
+		Ar << Entry.Component;
+		Ar << Entry.MeshHash;
+
+		uint32 NumSlots = Entry.NumSlots;
+		Ar.SerializeIntPacked(NumSlots);
+		if (Ar.IsLoading())
+		{
+			Entry.FirstSlot = Materials.Num();
+			Entry.NumSlots = NumSlots;
+		}
+
+		for (uint32 Slot = 0; Slot < NumSlots && !Ar.IsError(); ++Slot)
+		{
+			uint32 SlotIndex = Ar.IsSaving() ? SlotIndexes[Entry.FirstSlot + Slot] : 0;
+			Ar.SerializeIntPacked(SlotIndex);
+			if (Ar.IsLoading())
+			{
+				if (SlotIndex > static_cast<uint32>(MaterialTable.Num()))
+				{
+					Ar.SetError();
+					break;
+				}
+				Materials.Add(SlotIndex ? TSoftObjectPtr<UMaterialInterface>(MaterialTable[SlotIndex - 1]) : nullptr);
+			}
+		}
+
+		// Index paths hold INDEX_NONE for components their parent didn't list, so they're stored plus one.
+		uint32 PathLength = Entry.PathLength;
+		Ar.SerializeIntPacked(PathLength);
+		if (Ar.IsLoading())
+		{
+			Entry.FirstPathIndex = IndexPaths.Num();
+			Entry.PathLength = PathLength;
+		}
+
+		for (uint32 Step = 0; Step < PathLength && !Ar.IsError(); ++Step)
+		{
+			uint32 PackedIndex = Ar.IsSaving() ? static_cast<uint32>(IndexPaths[Entry.FirstPathIndex + Step] + 1) : 0;
+			Ar.SerializeIntPacked(PackedIndex);
+			if (Ar.IsLoading())
+			{
+				IndexPaths.Add(static_cast<int32>(PackedIndex) - 1);
+			}
+		}
+	}
+
+	return true;
+}
+
+int64 FSimpleSurfaceMeshCatalog::GetSavedSize(const bool bCompact) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes, /*bIsPersistent=*/true);
+
+	auto& Catalog = const_cast<FSimpleSurfaceMeshCatalog&>(*this);
+	if (!bCompact || !Catalog.Serialize(Writer))
+	{
+		StaticStruct()->SerializeTaggedProperties(Writer, reinterpret_cast<uint8*>(&Catalog), StaticStruct(), nullptr);
+	}
+	return Bytes.Num();
+}
+
+uint32 FSimpleSurfaceMeshCatalog::GetMeshHash(UMeshComponent* MeshComponent)
+{
+	if (!MeshComponent)
+	{
+		return 0;
+	}
+		
+	return HashCombine(GetTypeHash(MeshComponent), FSimpleSurfaceMeshIdentity::Get().GetMeshIdentity(*MeshComponent));
+}
+
+TArray<int32, TInlineAllocator<8>> FSimpleSurfaceMeshCatalog::GetIndexPath(const USceneComponent& Component)
+{
+	// Collected from the component up, then reversed, rather than inserting at the front at every level.
+	TArray<int32, TInlineAllocator<8>> Result;
+	const USceneComponent* Current = &Component;
+	while (const auto Parent = Current->GetAttachParent())
+	{
+		Result.Add(Parent->GetAttachChildren().Find(const_cast<USceneComponent*>(Current)));
+		Current = Parent;
+	}
+	Algo::Reverse(Result);
+	return Result;
+}
@@ -0,0 +1,158 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceMeshIdentity.h"
+
+#include "Components/DynamicMeshComponent.h"
+#include "Components/MeshComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Misc/ScopeRWLock.h"
+#include "UDynamicMesh.h"
+
+FSimpleSurfaceMeshIdentity& FSimpleSurfaceMeshIdentity::Get()
+{
+	static FSimpleSurfaceMeshIdentity Identity;
+	return Identity;
+}
+
+void FSimpleSurfaceMeshIdentity::RegisterProvider(const UClass* ComponentClass, FProvider Provider, const bool bIsThreadSafe)
+{
+	check(IsInGameThread());
+	check(ComponentClass && ComponentClass->IsChildOf<UMeshComponent>());
+
+	Providers.Add(ComponentClass, { MoveTemp(Provider), bIsThreadSafe });
+
+	// Providers may have moved in memory, and classes may now resolve to a closer provider.
+	FWriteScopeLock Lock(ResolvedProvidersLock);
+	ResolvedProviders.Reset();
+}
+
+void FSimpleSurfaceMeshIdentity::UnregisterProvider(const UClass* ComponentClass)
+{
+	check(IsInGameThread());
+
+	Providers.Remove(ComponentClass);
+
+	FWriteScopeLock Lock(ResolvedProvidersLock);
+	ResolvedProviders.Reset();
+}
+
+uint32 FSimpleSurfaceMeshIdentity::GetMeshIdentity(const UMeshComponent& Component) const
+{
+	if (const auto Provider = FindProvider(Component.GetClass()))
+	{
+		return Provider->Provider(Component);
+	}
+	return GetTypeHash(Component.GetNumMaterials());
+}
+
+bool FSimpleSurfaceMeshIdentity::IsThreadSafe(const UMeshComponent& Component) const
+{
+	const auto Provider = FindProvider(Component.GetClass());
+	return !Provider || Provider->bIsThreadSafe;
+}
+
+const FSimpleSurfaceMeshIdentity::FRegisteredProvider* FSimpleSurfaceMeshIdentity::FindProvider(const UClass* ComponentClass) const
+{
+	{
+		FReadScopeLock Lock(ResolvedProvidersLock);
+		if (const auto Resolved = ResolvedProviders.Find(ComponentClass))
+		{
+			return *Resolved;
+		}
+	}
+
+	// Walk up the class hierarchy once per class; afterwards, resolution is a single lookup.
+	const FRegisteredProvider* Provider = nullptr;
+	for (auto Class = ComponentClass; Class && !Provider; Class = Class->GetSuperClass())
+	{
+		Provider = Providers.Find(Class);
+	}
+
+	FWriteScopeLock Lock(ResolvedProvidersLock);
+	ResolvedProviders.Add(ComponentClass, Provider);
+	return Provider;
+}
+
+uint32 FSimpleSurfaceMeshIdentity::GetChangeStamp(UDynamicMesh& DynamicMesh)
+{
+	check(IsInGameThread());
+
+	if (const auto Tracked = TrackedDynamicMeshes.Find(&DynamicMesh))
+	{
+		return Tracked->ChangeStamp;
+	}
+
+	// Meshes that were destroyed leave their entries behind; drop them before the map grows.
+	if (TrackedDynamicMeshes.Num() >= 256 && FMath::IsPowerOfTwo(TrackedDynamicMeshes.Num()))
+	{
+		for (auto It = TrackedDynamicMeshes.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// Start counting edits the first time a mesh is asked about.  Any edit after that changes the stamp, even one
+	// that leaves the mesh's size unchanged.
+	auto& Tracked = TrackedDynamicMeshes.Add(&DynamicMesh);
+	const TObjectKey<UDynamicMesh> MeshKey(&DynamicMesh);
+	Tracked.ChangedHandle = DynamicMesh.OnMeshChanged().AddLambda([this, MeshKey](UDynamicMesh*, FDynamicMeshChangeInfo)
+	{
+		if (auto Changed = TrackedDynamicMeshes.Find(MeshKey))
+		{
+			++Changed->ChangeStamp;
+		}
+	});
+	return Tracked.ChangeStamp;
+}
+
+void FSimpleSurfaceMeshIdentity::RegisterBuiltInProviders()
+{
+	// Covers instanced and spline meshes too.
+	RegisterProvider(UStaticMeshComponent::StaticClass(), [](const UMeshComponent& Component)
+	{
+		return GetTypeHash(static_cast<const UStaticMeshComponent&>(Component).GetStaticMesh());
+	}, /*bIsThreadSafe=*/true);
+
+	RegisterProvider(USkinnedMeshComponent::StaticClass(), [](const UMeshComponent& Component)
+	{
+		return GetTypeHash(static_cast<const USkinnedMeshComponent&>(Component).GetSkinnedAsset());
+	}, /*bIsThreadSafe=*/true);
+
+	RegisterProvider(UDynamicMeshComponent::StaticClass(), [this](const UMeshComponent& Component)
+	{
+		const auto DynamicMesh = const_cast<UDynamicMeshComponent&>(static_cast<const UDynamicMeshComponent&>(Component)).GetDynamicMesh();
+		return DynamicMesh ? HashCombineFast(GetTypeHash(DynamicMesh), GetChangeStamp(*DynamicMesh)) : 0;
+	});
+}
+
+void FSimpleSurfaceMeshIdentity::Reset()
+{
+	for (const auto& Tracked : TrackedDynamicMeshes)
+	{
+		if (const auto DynamicMesh = Tracked.Key.ResolveObjectPtr())
+		{
+			DynamicMesh->OnMeshChanged().Remove(Tracked.Value.ChangedHandle);
+		}
+	}
+	TrackedDynamicMeshes.Empty();
+
+	Providers.Empty();
+
+	FWriteScopeLock Lock(ResolvedProvidersLock);
+	ResolvedProviders.Empty();
+}
@@ -0,0 +1,143 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceParameterCache.h"
+
+#include "Materials/MaterialInstanceDynamic.h"
+
+namespace
+{
+	/**
+	 * Sets a scalar parameter by its cached index, if the material has that parameter and the value changed.
+	 */
+	bool PushScalar(UMaterialInstanceDynamic& Material, const int32 Index, const float OldValue, const float NewValue)
+	{
+		return Index != INDEX_NONE && OldValue != NewValue && Material.SetScalarParameterByIndex(Index, NewValue);
+	}
+
+	/**
+	 * Packs the animation's target color and glow into one vector parameter.
+	 */
+	FLinearColor GetAnimationTarget(const FSimpleSurfaceAnimation& Animation)
+	{
+		FLinearColor Target(Animation.TargetColor);
+		Target.A = Animation.TargetGlow;
+		return Target;
+	}
+
+	/**
+	 * Packs the animation's start time, duration, pulse count and easing into one vector parameter.
+	 */
+	FLinearColor GetAnimationTiming(const FSimpleSurfaceAnimation& Animation)
+	{
+		const float NumPulses = Animation.Mode == ESimpleSurfaceAnimationMode::Pulse ? Animation.NumPulses : 1.0f;
+		return FLinearColor(Animation.StartTime, Animation.Duration, NumPulses, static_cast<float>(Animation.Easing));
+	}
+}
+
+int32 FSimpleSurfaceParameterCache::Apply(UMaterialInstanceDynamic& Material, const FSimpleSurfaceParameters& Parameters)
+{
+	if (CachedMaterial.Get() != &Material)
+	{
+		Initialize(Material, Parameters);
+		return NumParameters;
+	}
+
+	const FSimpleSurfaceParameters& Old = PushedParameters;
+	int32 PushCount = 0;
+
+	if (Old.Color != Parameters.Color && ColorIndex != INDEX_NONE)
+	{
+		PushCount += Material.SetVectorParameterByIndex(ColorIndex, FLinearColor(Parameters.Color)) ? 1 : 0;
+	}
+
+	PushCount += PushScalar(Material, GlowIndex, Old.Glow, Parameters.Glow) ? 1 : 0;
+	PushCount += PushScalar(Material, WaxinessMetalnessIndex, Old.WaxinessMetalness, Parameters.WaxinessMetalness) ? 1 : 0;
+	PushCount += PushScalar(Material, ShininessRoughnessIndex, Old.ShininessRoughness, Parameters.ShininessRoughness) ? 1 : 0;
+
+	if (Old.Texture != Parameters.Texture)
+	{
+		Material.SetTextureParameterValueByInfo(FMaterialParameterInfo(SimpleSurfaceParameterNames::Texture), Parameters.Texture.Get());
+		++PushCount;
+	}
+	PushCount += PushScalar(Material, TextureIntensityIndex, Old.TextureIntensity, Parameters.TextureIntensity) ? 1 : 0;
+	PushCount += PushScalar(Material, TextureScaleIndex, Old.TextureScale, Parameters.TextureScale) ? 1 : 0;
+
+	PushCount += PushScalar(Material, ShowGridIndex, Old.ShowGrid, Parameters.ShowGrid) ? 1 : 0;
+	PushCount += PushScalar(Material, GridSizeIndex, Old.GridParams.GridSize, Parameters.GridParams.GridSize) ? 1 : 0;
+	PushCount += PushScalar(Material, SubGridNumberIndex, Old.GridParams.SubGridDivisions, Parameters.GridParams.SubGridDivisions) ? 1 : 0;
+	PushCount += PushScalar(Material, ObjectAlignedIndex,
+		Old.GridParams.bIsObjectAligned ? 1.0f : 0.0f, Parameters.GridParams.bIsObjectAligned ? 1.0f : 0.0f) ? 1 : 0;
+
+	// The material evaluates the animation itself; these only change when one is played or stopped.
+	if (Old.Animation != Parameters.Animation)
+	{
+		PushCount += PushScalar(Material, AnimationModeIndex,
+			static_cast<float>(Old.Animation.Mode), static_cast<float>(Parameters.Animation.Mode)) ? 1 : 0;
+
+		const FLinearColor Target = GetAnimationTarget(Parameters.Animation);
+		if (AnimationTargetIndex != INDEX_NONE && GetAnimationTarget(Old.Animation) != Target)
+		{
+			PushCount += Material.SetVectorParameterByIndex(AnimationTargetIndex, Target) ? 1 : 0;
+		}
+
+		const FLinearColor Timing = GetAnimationTiming(Parameters.Animation);
+		if (AnimationTimingIndex != INDEX_NONE && GetAnimationTiming(Old.Animation) != Timing)
+		{
+			PushCount += Material.SetVectorParameterByIndex(AnimationTimingIndex, Timing) ? 1 : 0;
+		}
+	}
+
+	PushedParameters = Parameters;
+	return PushCount;
+}
+
+void FSimpleSurfaceParameterCache::Reset()
+{
+	CachedMaterial.Reset();
+}
+
+void FSimpleSurfaceParameterCache::Initialize(UMaterialInstanceDynamic& Material, const FSimpleSurfaceParameters& Parameters)
+{
+	using namespace SimpleSurfaceParameterNames;
+
+	// Parameters the material doesn't expose leave their index at INDEX_NONE and are skipped from then on.
+	for (int32* Index : { &ColorIndex, &GlowIndex, &WaxinessMetalnessIndex, &ShininessRoughnessIndex, &TextureIntensityIndex,
+		&TextureScaleIndex, &ShowGridIndex, &GridSizeIndex, &SubGridNumberIndex, &ObjectAlignedIndex, &AnimationModeIndex,
+		&AnimationTargetIndex, &AnimationTimingIndex })
+	{
+		*Index = INDEX_NONE;
+	}
+
+	Material.InitializeVectorParameterAndGetIndex(Color, FLinearColor(Parameters.Color), ColorIndex);
+
+	Material.InitializeScalarParameterAndGetIndex(Glow, Parameters.Glow, GlowIndex);
+	Material.InitializeScalarParameterAndGetIndex(WaxinessMetalness, Parameters.WaxinessMetalness, WaxinessMetalnessIndex);
+	Material.InitializeScalarParameterAndGetIndex(ShininessRoughness, Parameters.ShininessRoughness, ShininessRoughnessIndex);
+
+	Material.SetTextureParameterValueByInfo(FMaterialParameterInfo(Texture), Parameters.Texture.Get());
+	Material.InitializeScalarParameterAndGetIndex(TextureIntensity, Parameters.TextureIntensity, TextureIntensityIndex);
+	Material.InitializeScalarParameterAndGetIndex(TextureScale, Parameters.TextureScale, TextureScaleIndex);
+
+	Material.InitializeScalarParameterAndGetIndex(ShowGrid, Parameters.ShowGrid, ShowGridIndex);
+	Material.InitializeScalarParameterAndGetIndex(GridSize, Parameters.GridParams.GridSize, GridSizeIndex);
+	Material.InitializeScalarParameterAndGetIndex(SubGridNumber, Parameters.GridParams.SubGridDivisions, SubGridNumberIndex);
+	Material.InitializeScalarParameterAndGetIndex(ObjectAligned, Parameters.GridParams.bIsObjectAligned ? 1.0f : 0.0f, ObjectAlignedIndex);
+
+	Material.InitializeScalarParameterAndGetIndex(AnimationMode, static_cast<float>(Parameters.Animation.Mode), AnimationModeIndex);
+	Material.InitializeVectorParameterAndGetIndex(AnimationTarget, GetAnimationTarget(Parameters.Animation), AnimationTargetIndex);
+	Material.InitializeVectorParameterAndGetIndex(AnimationTiming, GetAnimationTiming(Parameters.Animation), AnimationTimingIndex);
+
+	CachedMaterial = &Material;
+	PushedParameters = Parameters;
+}
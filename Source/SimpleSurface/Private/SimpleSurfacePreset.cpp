@@ -0,0 +1,76 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+
+#include "SimpleSurfacePreset.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+FSimpleSurfaceParameters USimpleSurfacePreset::GetParameters() const
+{
+	FSimpleSurfaceParameters Parameters;
+	Parameters.Color = Color;
+	Parameters.Glow = Glow;
+	Parameters.ShininessRoughness = ShininessRoughness;
+	Parameters.WaxinessMetalness = WaxinessMetalness;
+	Parameters.TextureIntensity = TextureIntensity;
+	Parameters.TextureScale = TextureScale;
+	Parameters.Texture = Texture.Get();
+	Parameters.ShowGrid = ShowGrid;
+	Parameters.GridParams = GridParams;
+	return Parameters;
+}
+
+UMaterialInstanceDynamic* USimpleSurfacePreset::GetMaterial(UMaterialInterface* Parent)
+{
+	if (!Material || Material->Parent != Parent)
+	{
+		// Shared by surfaces in any number of packages and worlds, so it must never be saved.
+		const FName Name = MakeUniqueObjectName(this, UMaterialInstanceDynamic::StaticClass(), TEXT("SimpleSurfaceMaterial"));
+		Material = UMaterialInstanceDynamic::Create(Parent, this, Name);
+		Material->SetFlags(RF_Transient);
+		MaterialFeatures = GetParameters().GetFeatures();
+
+		UE_LOG(LogSimpleSurface, Verbose, TEXT("Created material %s for preset %s"), *Name.ToString(), *GetName())
+	}
+
+	// Textures finish streaming in after the instance is created; the cache makes this a comparison otherwise.
+	ParameterCache.Apply(*Material, GetParameters());
+	return Material;
+}
+
+void USimpleSurfacePreset::NotifyChanged()
+{
+	if (!Material)
+	{
+		PresetChangedEvent.Broadcast(false);
+		return;
+	}
+
+	// Turning a feature on or off can move the preset to another permutation; surfaces then ask for the instance again.
+	const FSimpleSurfaceParameters Parameters = GetParameters();
+	const bool bFeaturesChanged = Parameters.GetFeatures() != MaterialFeatures;
+	MaterialFeatures = Parameters.GetFeatures();
+
+	ParameterCache.Apply(*Material, Parameters);
+	PresetChangedEvent.Broadcast(bFeaturesChanged);
+}
+
+#if WITH_EDITOR
+void USimpleSurfacePreset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	NotifyChanged();
+}
+#endif
@@ -0,0 +1,375 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+
+#include "SimpleSurfaceRules.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "SimpleSurfaceParameterCache.h"
+#include "SimpleSurfacePreset.h"
+#include "SimpleSurfaceStats.h"
+#include "SimpleSurfaceSubsystem.h"
+#include "Components/MeshComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Materials/MaterialInstance.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/ConstructorHelpers.h"
+#include "WorldPartition/DataLayer/DataLayerAsset.h"
+
+bool FSimpleSurfaceRule::Matches(const AActor& Actor) const
+{
+	if (ActorClass && !Actor.IsA(ActorClass))
+	{
+		return false;
+	}
+
+	if (!Tag.IsNone() && !Actor.ActorHasTag(Tag))
+	{
+		return false;
+	}
+
+	if (!Folder.IsNone())
+	{
+#if WITH_EDITOR
+		const FString ActorFolder = Actor.GetFolderPath().ToString();
+		const FString RuleFolder = Folder.ToString();
+		if (ActorFolder != RuleFolder && !ActorFolder.StartsWith(RuleFolder + TEXT("/")))
+		{
+			return false;
+		}
+#else
+		return false;
+#endif
+	}
+
+	if (DataLayer && !Actor.ContainsDataLayer(DataLayer))
+	{
+		return false;
+	}
+
+	if (!NamePattern.IsEmpty() && !Actor.GetActorNameOrLabel().MatchesWildcard(NamePattern))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+ASimpleSurfaceRules::ASimpleSurfaceRules()
+{
+	static ConstructorHelpers::FObjectFinder<UMaterialInstance> MaterialFinder(
+		TEXT("/SimpleSurface/Materials/MI_SimpleSurface.MI_SimpleSurface"));
+
+	if (MaterialFinder.Succeeded())
+	{
+		BaseMaterial = MaterialFinder.Object;
+	}
+}
+
+void ASimpleSurfaceRules::ReapplyRules()
+{
+	bRulesDirty = true;
+	QueueUpdate();
+}
+
+void ASimpleSurfaceRules::QueueUpdate()
+{
+	if (auto Subsystem = GetWorld() ? GetWorld()->GetSubsystem<USimpleSurfaceSubsystem>() : nullptr)
+	{
+		Subsystem->QueueRulesUpdate(*this);
+	}
+	else
+	{
+		FlushPendingRules();
+	}
+}
+
+void ASimpleSurfaceRules::FlushPendingRules()
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_ApplyRules);
+
+	if (bRulesDirty)
+	{
+		ApplyRules();
+		return;
+	}
+
+	if (PendingActors.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<AActor*> Actors;
+	Actors.Reserve(PendingActors.Num());
+	for (const auto& PendingActor : PendingActors)
+	{
+		if (auto SafeActor = PendingActor.Get())
+		{
+			Actors.Add(SafeActor);
+		}
+	}
+	PendingActors.Reset();
+
+	ApplyToActors(Actors);
+}
+
+void ASimpleSurfaceRules::ApplyRules()
+{
+	bRulesDirty = false;
+	PendingActors.Reset();
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	UpdateRuleMaterials();
+
+	TArray<AActor*> Actors;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		Actors.Add(*It);
+	}
+
+	// Actors that no longer exist can't be restored; just forget them.
+	for (auto It = AppliedRules.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	MeshCatalog.RemoveStaleEntries();
+
+	ApplyToActors(Actors);
+}
+
+void ASimpleSurfaceRules::ApplyToActors(TConstArrayView<AActor*> Actors)
+{
+	TArray<UMeshComponent*> MeshComponents;
+	TArray<UMaterialInterface*> MeshMaterials;
+	TSet<TObjectKey<UMeshComponent>> RestoredComponents;
+
+	TArray<UMeshComponent*, TInlineAllocator<16>> ActorMeshComponents;
+	for (AActor* Actor : Actors)
+	{
+		// Actors with their own SimpleSurfaceComponent are left to it.
+		const bool bEligible = IsValid(Actor) && Actor != this && !Actor->FindComponentByClass<USimpleSurfaceComponent>();
+		const int32 RuleIndex = bEligible ? FindRule(*Actor) : INDEX_NONE;
+		UMaterialInterface* Material = RuleMaterials.IsValidIndex(RuleIndex) ? RuleMaterials[RuleIndex].Get() : nullptr;
+
+		ActorMeshComponents.Reset();
+		if (Actor)
+		{
+			Actor->GetComponents<UMeshComponent>(ActorMeshComponents);
+		}
+
+		if (!Material)
+		{
+			// An actor that stopped matching gets its original materials back.
+			if (AppliedRules.Remove(Actor) > 0)
+			{
+				for (UMeshComponent* MeshComponent : ActorMeshComponents)
+				{
+					RestoredComponents.Add(MeshComponent);
+				}
+			}
+			continue;
+		}
+
+		AppliedRules.Add(Actor, RuleIndex);
+		for (UMeshComponent* MeshComponent : ActorMeshComponents)
+		{
+			MeshComponents.Add(MeshComponent);
+			MeshMaterials.Add(Material);
+		}
+	}
+
+	if (!RestoredComponents.IsEmpty())
+	{
+		const auto IsRestored = [&RestoredComponents](const FSimpleSurfaceMeshCatalogEntry& Entry)
+		{
+			return RestoredComponents.Contains(Entry.Component.Get());
+		};
+		for (const auto& Entry : MeshCatalog.Entries)
+		{
+			if (IsRestored(Entry))
+			{
+				MeshCatalog.ApplyMaterials(Entry, *Entry.Component.Get());
+			}
+		}
+		MeshCatalog.RemoveEntries(IsRestored);
+	}
+
+	if (MeshComponents.IsEmpty())
+	{
+		return;
+	}
+
+	// One pass over the world's catalog for the whole batch, rather than one per actor.
+	MeshCatalog.Capture(MeshComponents);
+
+	TArray<UMaterialInterface*, TInlineAllocator<16>> SlotMaterials;
+	for (int32 i = 0; i < MeshComponents.Num(); ++i)
+	{
+		SlotMaterials.Init(MeshMaterials[i], MeshComponents[i]->GetNumMaterials());
+		FSimpleSurfaceMeshCatalog::AssignMaterials(*MeshComponents[i], SlotMaterials, /*bAlwaysMarkDirty=*/false);
+	}
+}
+
+void ASimpleSurfaceRules::RestoreAll()
+{
+	for (const auto& Entry : MeshCatalog.Entries)
+	{
+		if (auto SafeComponent = Entry.Component.Get())
+		{
+			MeshCatalog.ApplyMaterials(Entry, *SafeComponent);
+		}
+	}
+
+	MeshCatalog.RemoveEntries([](const FSimpleSurfaceMeshCatalogEntry&) { return true; });
+	AppliedRules.Reset();
+	PendingActors.Reset();
+	bRulesDirty = false;
+}
+
+void ASimpleSurfaceRules::UpdateRuleMaterials()
+{
+	for (const auto& Subscription : PresetSubscriptions)
+	{
+		if (auto SafePreset = Subscription.Key.Get())
+		{
+			SafePreset->OnPresetChanged().Remove(Subscription.Value);
+		}
+	}
+	PresetSubscriptions.Reset();
+
+	RuleMaterials.SetNum(Rules.Num());
+	for (int32 i = 0; i < Rules.Num(); ++i)
+	{
+		const auto& Rule = Rules[i];
+		const FSimpleSurfaceParameters Parameters = Rule.Preset ? Rule.Preset->GetParameters() : Rule.Parameters;
+
+		UMaterialInterface* Parent = USimpleSurfaceSubsystem::GetPermutationMaterial(Parameters.GetFeatures());
+		if (!Parent)
+		{
+			Parent = BaseMaterial;
+		}
+
+		if (Rule.Preset)
+		{
+			// A preset's instance is shared with every component using it; features changing may replace it.
+			RuleMaterials[i] = Rule.Preset->GetMaterial(Parent);
+			PresetSubscriptions.Emplace(Rule.Preset, Rule.Preset->OnPresetChanged().AddUObject(this, &ASimpleSurfaceRules::OnPresetChanged));
+			continue;
+		}
+
+		auto Material = Cast<UMaterialInstanceDynamic>(RuleMaterials[i]);
+		if (!Material || Material->GetOuter() != this || Material->Parent != Parent)
+		{
+			// Never saved; rules re-apply their materials when they're loaded.
+			const FName Name = MakeUniqueObjectName(this, UMaterialInstanceDynamic::StaticClass(), TEXT("SimpleSurfaceMaterial"));
+			Material = UMaterialInstanceDynamic::Create(Parent, this, Name);
+			Material->SetFlags(RF_Transient);
+			RuleMaterials[i] = Material;
+		}
+		FSimpleSurfaceParameterCache().Apply(*Material, Parameters);
+	}
+}
+
+int32 ASimpleSurfaceRules::FindRule(const AActor& Actor) const
+{
+	return Rules.IndexOfByPredicate([&Actor](const FSimpleSurfaceRule& Rule) { return Rule.Matches(Actor); });
+}
+
+void ASimpleSurfaceRules::OnActorSpawned(AActor* Actor)
+{
+	PendingActors.Add(Actor);
+	QueueUpdate();
+}
+
+void ASimpleSurfaceRules::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		ReapplyRules();
+	}
+}
+
+void ASimpleSurfaceRules::OnPresetChanged(const bool bFeaturesChanged)
+{
+	// Otherwise the preset updated its instance in place, and every matching actor already shows the change.
+	if (bFeaturesChanged)
+	{
+		ReapplyRules();
+	}
+}
+
+void ASimpleSurfaceRules::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+	UWorld* World = GetWorld();
+	if (!World || HasAnyFlags(RF_ClassDefaultObject))
+	{
+		return;
+	}
+
+	if (!ActorSpawnedHandle.IsValid())
+	{
+		ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ASimpleSurfaceRules::OnActorSpawned));
+	}
+	if (!LevelAddedHandle.IsValid())
+	{
+		LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ASimpleSurfaceRules::OnLevelAdded);
+	}
+
+	ReapplyRules();
+}
+
+void ASimpleSurfaceRules::PostUnregisterAllComponents()
+{
+	if (UWorld* World = GetWorld(); World && ActorSpawnedHandle.IsValid())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	ActorSpawnedHandle.Reset();
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	LevelAddedHandle.Reset();
+
+	Super::PostUnregisterAllComponents();
+}
+
+void ASimpleSurfaceRules::Destroyed()
+{
+	RestoreAll();
+	Super::Destroyed();
+}
+
+#if WITH_EDITOR
+void ASimpleSurfaceRules::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	ReapplyRules();
+}
+
+void ASimpleSurfaceRules::PostEditUndo()
+{
+	Super::PostEditUndo();
+	ReapplyRules();
+}
+#endif
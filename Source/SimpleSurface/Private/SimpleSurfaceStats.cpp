@@ -0,0 +1,179 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceStats.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "SimpleSurfacePreset.h"
+#include "SimpleSurfaceRules.h"
+#include "SimpleSurfaceSubsystem.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/UObjectIterator.h"
+
+DEFINE_STAT(STAT_SimpleSurface_MonitorComponents);
+DEFINE_STAT(STAT_SimpleSurface_PollForChanges);
+DEFINE_STAT(STAT_SimpleSurface_MonitorForChanges);
+DEFINE_STAT(STAT_SimpleSurface_ProcessPendingChanges);
+DEFINE_STAT(STAT_SimpleSurface_UpdateMeshCatalog);
+DEFINE_STAT(STAT_SimpleSurface_ApplyParametersToMaterial);
+DEFINE_STAT(STAT_SimpleSurface_ApplyMaterialToMeshes);
+DEFINE_STAT(STAT_SimpleSurface_TryRestoreMaterials);
+DEFINE_STAT(STAT_SimpleSurface_WriteCustomData);
+DEFINE_STAT(STAT_SimpleSurface_ApplyRules);
+DEFINE_STAT(STAT_SimpleSurface_UpdateDistanceLOD);
+
+DEFINE_STAT(STAT_SimpleSurface_Components);
+DEFINE_STAT(STAT_SimpleSurface_PooledMaterials);
+DEFINE_STAT(STAT_SimpleSurface_ComponentsChecked);
+DEFINE_STAT(STAT_SimpleSurface_Reapplies);
+
+UE_TRACE_CHANNEL_DEFINE(SimpleSurfaceChannel);
+
+uint64 SimpleSurfaceStats::NumReapplies = 0;
+
+namespace SimpleSurfaceStats
+{
+	/** When the stats were last reported, to turn counts into rates. */
+	double LastReportTime = 0.0;
+	uint64 LastReportedReapplies = 0;
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice ReportCommand(
+		TEXT("SimpleSurface.Stats"),
+		TEXT("Reports SimpleSurface's components, materials, catalogs, re-apply rate and the actors costing the most since the last report.  Optional argument: the number of slowest actors to list (default 10)."),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&FSimpleSurfaceStatsReport::Report));
+}
+
+void FSimpleSurfaceStatsReport::Report(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	using namespace SimpleSurfaceStats;
+
+	if (!World)
+	{
+		Ar.Log(TEXT("SimpleSurface.Stats: no world."));
+		return;
+	}
+
+	const int32 NumSlowest = Args.IsEmpty() ? 10 : FMath::Max(FCString::Atoi(*Args[0]), 0);
+	const auto Subsystem = World->GetSubsystem<USimpleSurfaceSubsystem>();
+
+	int32 NumComponents = 0;
+	int32 NumActiveComponents = 0;
+	TSet<const UMaterialInstanceDynamic*> ComponentMaterials;
+	int32 NumCatalogEntries = 0;
+	SIZE_T CatalogBytes = 0;
+	int64 SavedCatalogBytes = 0;
+	int64 TaggedCatalogBytes = 0;
+	TMap<const UObject*, double> CostsByActor;
+
+	for (TObjectIterator<USimpleSurfaceComponent> It; It; ++It)
+	{
+		const auto Component = *It;
+		if (Component->GetWorld() != World || !Component->IsRegistered())
+		{
+			continue;
+		}
+
+		++NumComponents;
+		NumActiveComponents += Component->IsActive() ? 1 : 0;
+		NumCatalogEntries += Component->GetMeshCatalog().Entries.Num();
+		CatalogBytes += Component->GetMeshCatalog().GetAllocatedSize();
+		SavedCatalogBytes += Component->GetMeshCatalog().GetSavedSize();
+		TaggedCatalogBytes += Component->GetMeshCatalog().GetSavedSize(/*bCompact=*/false);
+
+		if (const auto Material = Component->GetSimpleSurfaceMaterial())
+		{
+			ComponentMaterials.Add(Material);
+		}
+
+		// An actor may have several surfaces; it costs what they all do.  Ownerless components stand on their own.
+		const UObject* Actor = Component->GetOwner() ? static_cast<const UObject*>(Component->GetOwner()) : Component;
+		CostsByActor.FindOrAdd(Actor) += FPlatformTime::ToMilliseconds64(Component->GetMonitoringCycles());
+	}
+
+	// Components sharing a preset's instance all reference it; count each instance once, by owner.
+	int32 NumPresetMaterials = 0;
+	int32 NumComponentMaterials = 0;
+	for (const auto Material : ComponentMaterials)
+	{
+		if (Material->GetOuter()->IsA<USimpleSurfacePreset>())
+		{
+			++NumPresetMaterials;
+		}
+		else if (!(Subsystem && Subsystem->IsPooledMaterial(Material)))
+		{
+			++NumComponentMaterials;
+		}
+	}
+
+	// Rules assign their instances to meshes directly, so they're found through the rules actors.
+	int32 NumRulesMaterials = 0;
+	for (TActorIterator<ASimpleSurfaceRules> It(World); It; ++It)
+	{
+		ForEachObjectWithOuter(*It, [&NumRulesMaterials](const UObject* Object)
+		{
+			NumRulesMaterials += Object->IsA<UMaterialInstanceDynamic>() ? 1 : 0;
+		}, /*bIncludeNestedObjects=*/false);
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - LastReportTime;
+	const bool bReportedBefore = LastReportTime > 0.0 && Elapsed > 0.0;
+
+	Ar.Logf(TEXT("SimpleSurface stats for %s:"), *World->GetName());
+	Ar.Logf(TEXT("  Components: %d (%d active, %d monitored by the subsystem)"), NumComponents, NumActiveComponents, Subsystem ? Subsystem->GetLastFrameStats().NumMonitored : 0);
+	Ar.Logf(TEXT("  Material instances: %d pooled, %d preset, %d rules, %d per component"), Subsystem ? Subsystem->GetNumPooledMaterials() : 0,
+		NumPresetMaterials, NumRulesMaterials, NumComponentMaterials);
+	Ar.Logf(TEXT("  Distant surfaces: %d"), Subsystem ? Subsystem->GetNumDistantSurfaces() : 0);
+	Ar.Logf(TEXT("  Catalog entries: %d, %.1f KiB"), NumCatalogEntries, CatalogBytes / 1024.0);
+	Ar.Logf(TEXT("  Saved catalogs: ~%.1f KiB, ~%.1f KiB saved over tagged properties"), SavedCatalogBytes / 1024.0, (TaggedCatalogBytes - SavedCatalogBytes) / 1024.0);
+	if (bReportedBefore)
+	{
+		Ar.Logf(TEXT("  Re-applies: %.1f/s over the last %.1f s"), (NumReapplies - LastReportedReapplies) / Elapsed, Elapsed);
+	}
+	if (Subsystem)
+	{
+		const auto& FrameStats = Subsystem->GetLastFrameStats();
+		Ar.Logf(TEXT("  Last frame: %d checked, %d re-applied, %.3f ms"), FrameStats.NumChecked, FrameStats.NumReapplied, FrameStats.ElapsedMilliseconds);
+	}
+
+	// Costs accumulate between reports, so these are the slowest actors since the last report.
+	CostsByActor.ValueSort([](const double A, const double B) { return A > B; });
+	if (NumSlowest > 0 && !CostsByActor.IsEmpty())
+	{
+		Ar.Logf(TEXT("  Slowest actors%s:"), bReportedBefore ? TEXT(" since the last report") : TEXT(""));
+		int32 NumListed = 0;
+		for (const auto& Cost : CostsByActor)
+		{
+			if (NumListed++ >= NumSlowest)
+			{
+				break;
+			}
+			const auto Actor = Cast<AActor>(Cost.Key);
+			Ar.Logf(TEXT("    %8.3f ms  %s"), Cost.Value, Actor ? *Actor->GetActorNameOrLabel() : *Cost.Key->GetName());
+		}
+	}
+
+	for (TObjectIterator<USimpleSurfaceComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World)
+		{
+			It->ResetMonitoringCycles();
+		}
+	}
+	LastReportTime = Now;
+	LastReportedReapplies = NumReapplies;
+}
@@ -0,0 +1,73 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+DECLARE_STATS_GROUP(TEXT("SimpleSurface"), STATGROUP_SimpleSurface, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Monitor Components"), STAT_SimpleSurface_MonitorComponents, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Poll For Changes"), STAT_SimpleSurface_PollForChanges, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Monitor For Changes"), STAT_SimpleSurface_MonitorForChanges, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Process Pending Changes"), STAT_SimpleSurface_ProcessPendingChanges, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Mesh Catalog"), STAT_SimpleSurface_UpdateMeshCatalog, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Parameters To Material"), STAT_SimpleSurface_ApplyParametersToMaterial, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Material To Meshes"), STAT_SimpleSurface_ApplyMaterialToMeshes, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Try Restore Materials"), STAT_SimpleSurface_TryRestoreMaterials, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Write Custom Data"), STAT_SimpleSurface_WriteCustomData, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Rules"), STAT_SimpleSurface_ApplyRules, STATGROUP_SimpleSurface, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Distance LOD"), STAT_SimpleSurface_UpdateDistanceLOD, STATGROUP_SimpleSurface, );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registered Components"), STAT_SimpleSurface_Components, STATGROUP_SimpleSurface, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Materials"), STAT_SimpleSurface_PooledMaterials, STATGROUP_SimpleSurface, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Components Checked"), STAT_SimpleSurface_ComponentsChecked, STATGROUP_SimpleSurface, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Re-applies"), STAT_SimpleSurface_Reapplies, STATGROUP_SimpleSurface, );
+
+UE_TRACE_CHANNEL_EXTERN(SimpleSurfaceChannel);
+
+/**
+ * Attributes the enclosing scope to a SimpleSurface cycle stat and, in Unreal Insights, to a CPU event on the
+ * SimpleSurface trace channel.
+ */
+#define SIMPLESURFACE_SCOPE(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, SimpleSurfaceChannel)
+
+/**
+ * Implements the SimpleSurface.Stats console command.
+ */
+struct FSimpleSurfaceStatsReport
+{
+	static void Report(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+};
+
+namespace SimpleSurfaceStats
+{
+	/**
+	 * The number of times SimpleSurface was re-applied because a change was detected, in any world.
+	 */
+	extern uint64 NumReapplies;
+
+	/**
+	 * Records that a component re-applied SimpleSurface after detecting a change.
+	 */
+	inline void CountReapply()
+	{
+		++NumReapplies;
+		INC_DWORD_STAT(STAT_SimpleSurface_Reapplies);
+	}
+}
@@ -0,0 +1,718 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceSubsystem.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "SimpleSurfaceParameterCache.h"
+#include "SimpleSurfaceRules.h"
+#include "SimpleSurfaceStats.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Materials/MaterialInterface.h"
+#include "Async/ParallelFor.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/PackageName.h"
+
+static bool GSimpleSurfacePermutations = true;
+static FAutoConsoleVariableRef CVarSimpleSurfacePermutations(
+	TEXT("SimpleSurface.Permutations"),
+	GSimpleSurfacePermutations,
+	TEXT("If true, surfaces use pre-authored permutations of the SimpleSurface material with unused features switched off.  Applies as surfaces' parameters next change."));
+
+static float GSimpleSurfaceLODDistance = 0.0f;
+static FAutoConsoleVariableRef CVarSimpleSurfaceLODDistance(
+	TEXT("SimpleSurface.LOD.Distance"),
+	GSimpleSurfaceLODDistance,
+	TEXT("The distance, in centimeters, beyond which surfaces switch to a flat-color permutation of the SimpleSurface material.  0 disables distance LOD."));
+
+static float GSimpleSurfaceLODHysteresis = 0.1f;
+static FAutoConsoleVariableRef CVarSimpleSurfaceLODHysteresis(
+	TEXT("SimpleSurface.LOD.Hysteresis"),
+	GSimpleSurfaceLODHysteresis,
+	TEXT("How much farther than SimpleSurface.LOD.Distance, as a fraction of it, a surface must be to switch to the flat permutation.  Surfaces switch back within the distance itself, so ones near the boundary don't flicker."));
+
+static int32 GSimpleSurfaceLODSurfacesPerFrame = 256;
+static FAutoConsoleVariableRef CVarSimpleSurfaceLODSurfacesPerFrame(
+	TEXT("SimpleSurface.LOD.SurfacesPerFrame"),
+	GSimpleSurfaceLODSurfacesPerFrame,
+	TEXT("The number of surfaces whose distance is evaluated each frame."));
+
+static bool GSimpleSurfaceCentralMonitoring = true;
+static FAutoConsoleVariableRef CVarSimpleSurfaceCentralMonitoring(
+	TEXT("SimpleSurface.Monitor.Central"),
+	GSimpleSurfaceCentralMonitoring,
+	TEXT("If true, polling SimpleSurfaceComponents are checked for changes by the world's SimpleSurface subsystem instead of ticking.  Applies to components registered afterwards."));
+
+static float GSimpleSurfaceMonitorBudgetMs = 0.5f;
+static FAutoConsoleVariableRef CVarSimpleSurfaceMonitorBudgetMs(
+	TEXT("SimpleSurface.Monitor.BudgetMs"),
+	GSimpleSurfaceMonitorBudgetMs,
+	TEXT("Time, in milliseconds, the SimpleSurface subsystem may spend checking components for changes each frame.  At least one component is always checked."));
+
+static int32 GSimpleSurfaceMonitorMaxInterval = 16;
+static FAutoConsoleVariableRef CVarSimpleSurfaceMonitorMaxInterval(
+	TEXT("SimpleSurface.Monitor.MaxInterval"),
+	GSimpleSurfaceMonitorMaxInterval,
+	TEXT("The most frames that may pass between checks of a SimpleSurfaceComponent that hasn't changed in a while."));
+
+static int32 GSimpleSurfaceMonitorIdleChecksPerBackoff = 8;
+static FAutoConsoleVariableRef CVarSimpleSurfaceMonitorIdleChecksPerBackoff(
+	TEXT("SimpleSurface.Monitor.IdleChecksPerBackoff"),
+	GSimpleSurfaceMonitorIdleChecksPerBackoff,
+	TEXT("The number of consecutive checks finding no change after which the interval between a SimpleSurfaceComponent's checks doubles."));
+
+static bool GSimpleSurfaceMonitorParallel = true;
+static FAutoConsoleVariableRef CVarSimpleSurfaceMonitorParallel(
+	TEXT("SimpleSurface.Monitor.Parallel"),
+	GSimpleSurfaceMonitorParallel,
+	TEXT("If true, components due for a check are checked for changes in parallel, and only those that changed are re-applied on the game thread within SimpleSurface.Monitor.BudgetMs."));
+
+static int32 GSimpleSurfaceMonitorMinParallelChecks = 64;
+static FAutoConsoleVariableRef CVarSimpleSurfaceMonitorMinParallelChecks(
+	TEXT("SimpleSurface.Monitor.MinParallelChecks"),
+	GSimpleSurfaceMonitorMinParallelChecks,
+	TEXT("The fewest components due for a check that are checked in parallel; fewer are checked on the game thread."));
+
+UMaterialInterface* USimpleSurfaceSubsystem::GetCustomDataMaterial()
+{
+	static TWeakObjectPtr<UMaterialInterface> LoadedMaterial;
+	static bool bIsMissing = false;
+
+	if (!LoadedMaterial.IsValid() && !bIsMissing)
+	{
+		const auto& MaterialPath = GetDefault<USimpleSurfaceSubsystem>()->CustomDataMaterial;
+		if (!MaterialPath.IsNull() && FPackageName::DoesPackageExist(MaterialPath.GetLongPackageName()))
+		{
+			LoadedMaterial = MaterialPath.LoadSynchronous();
+		}
+
+		if (!LoadedMaterial.IsValid())
+		{
+			// Don't retry every frame; surfaces fall back to material instances instead.
+			bIsMissing = true;
+			UE_LOG(LogSimpleSurface, Warning, TEXT("Custom data material %s could not be loaded; using material instances instead."), *MaterialPath.ToString())
+		}
+	}
+
+	return LoadedMaterial.Get();
+}
+
+FString USimpleSurfaceSubsystem::GetPermutationName(const ESimpleSurfaceFeatures Features)
+{
+	FString Name = TEXT("MI_SimpleSurface");
+	if (!EnumHasAnyFlags(Features, ESimpleSurfaceFeatures::Grid))
+	{
+		Name += TEXT("_NoGrid");
+	}
+	else if (EnumHasAnyFlags(Features, ESimpleSurfaceFeatures::ObjectAligned))
+	{
+		Name += TEXT("_ObjectAligned");
+	}
+	if (!EnumHasAnyFlags(Features, ESimpleSurfaceFeatures::Texture))
+	{
+		Name += TEXT("_NoTexture");
+	}
+	if (!EnumHasAnyFlags(Features, ESimpleSurfaceFeatures::Glow))
+	{
+		Name += TEXT("_NoGlow");
+	}
+	return Name;
+}
+
+UMaterialInterface* USimpleSurfaceSubsystem::GetPermutationMaterial(ESimpleSurfaceFeatures Features)
+{
+	// Object alignment without a grid is no different from no grid, which keeps the set at 12 permutations.
+	if (!EnumHasAnyFlags(Features, ESimpleSurfaceFeatures::Grid))
+	{
+		Features &= ~ESimpleSurfaceFeatures::ObjectAligned;
+	}
+
+	// The default material handles the world-aligned, everything-on case itself.
+	if (!GSimpleSurfacePermutations || Features == ESimpleSurfaceFeatures::Default)
+	{
+		return nullptr;
+	}
+
+	struct FPermutation
+	{
+		TWeakObjectPtr<UMaterialInterface> Material;
+		bool bIsMissing = false;
+	};
+	static FPermutation Permutations[static_cast<int32>(ESimpleSurfaceFeatures::All) + 1];
+
+	auto& Permutation = Permutations[static_cast<int32>(Features)];
+	if (!Permutation.Material.IsValid() && !Permutation.bIsMissing)
+	{
+		const FString Name = GetPermutationName(Features);
+		const FString PackageName = GetDefault<USimpleSurfaceSubsystem>()->PermutationMaterialPath / Name;
+		if (FPackageName::DoesPackageExist(PackageName))
+		{
+			Permutation.Material = LoadObject<UMaterialInterface>(nullptr, *(PackageName + TEXT(".") + Name));
+		}
+
+		if (!Permutation.Material.IsValid())
+		{
+			// Not every permutation has to be authored; missing ones fall back to the default material.
+			Permutation.bIsMissing = true;
+			UE_LOG(LogSimpleSurface, Verbose, TEXT("No material permutation %s; using the default material."), *PackageName)
+		}
+	}
+
+	return Permutation.Material.Get();
+}
+
+void USimpleSurfaceSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_SimpleSurface_PooledMaterials, MaterialPool.Num());
+	MaterialPool.Empty();
+	KeysByMaterial.Empty();
+	for (const auto& Request : TextureRequests)
+	{
+		const auto& Handle = Request.Value.Handle;
+		if (Handle.IsValid() && Handle->IsLoadingInProgress())
+		{
+			Handle->CancelHandle();
+		}
+		else if (Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+	TextureRequests.Empty();
+	MonitoredSurfaces.Empty();
+	MonitoredSurfaceIndexes.Empty();
+	LODSurfaces.Empty();
+	LODSurfaceIndexes.Empty();
+	ChangedComponents.Empty();
+	DirtyParameterComponents.Empty();
+	PendingRuleSets.Empty();
+	OrphanedCatalogs.Empty();
+	Super::Deinitialize();
+}
+
+void USimpleSurfaceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushSurfaceParameters();
+	FlushRules();
+	FlushOrphanedCatalogs();
+	MonitorComponents();
+	UpdateDistanceLOD();
+
+	if (bPurgePending)
+	{
+		PurgeUnusedMaterials();
+	}
+}
+
+TStatId USimpleSurfaceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USimpleSurfaceSubsystem, STATGROUP_Tickables);
+}
+
+bool USimpleSurfaceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// Include preview worlds, so components in the Blueprint editor's viewport share materials too.
+	return Super::DoesSupportWorldType(WorldType) || WorldType == EWorldType::EditorPreview || WorldType == EWorldType::GamePreview;
+}
+
+UMaterialInstanceDynamic* USimpleSurfaceSubsystem::AcquireMaterial(UMaterialInterface* Parent, const FSimpleSurfaceParameters& Parameters)
+{
+	FSimpleSurfaceMaterialKey Key;
+	Key.Parent = Parent;
+	Key.Parameters = Parameters;
+
+	auto& Entry = MaterialPool.FindOrAdd(Key);
+	if (!Entry.Material)
+	{
+		// Pooled instances are shared by many actors, possibly in different packages, so they must never be saved.
+		// References to them are saved as null; SimpleSurfaceComponent re-applies its material when it's registered.
+		const FName Name = MakeUniqueObjectName(this, UMaterialInstanceDynamic::StaticClass(), TEXT("SimpleSurfaceMaterial"));
+		Entry.Material = UMaterialInstanceDynamic::Create(Parent, this, Name);
+		Entry.Material->SetFlags(RF_Transient);
+
+		FSimpleSurfaceParameterCache().Apply(*Entry.Material, Parameters);
+
+		KeysByMaterial.Add(Entry.Material.Get(), Key);
+		INC_DWORD_STAT(STAT_SimpleSurface_PooledMaterials);
+
+		UE_LOG(LogSimpleSurface, Verbose, TEXT("Created pooled material %s; %d pooled materials in %s"), *Name.ToString(), MaterialPool.Num(), *GetWorld()->GetName())
+	}
+
+	++Entry.RefCount;
+	return Entry.Material;
+}
+
+void USimpleSurfaceSubsystem::ReleaseMaterial(UMaterialInstanceDynamic* Material)
+{
+	if (const auto Key = KeysByMaterial.Find(Material))
+	{
+		if (auto Entry = MaterialPool.Find(*Key))
+		{
+			Entry->RefCount = FMath::Max(Entry->RefCount - 1, 0);
+			bPurgePending |= Entry->RefCount == 0;
+		}
+	}
+}
+
+bool USimpleSurfaceSubsystem::IsPooledMaterial(const UMaterialInterface* Material) const
+{
+	return Material && KeysByMaterial.Contains(Material);
+}
+
+bool USimpleSurfaceSubsystem::PooledMaterialMatches(const UMaterialInterface* Material, const UMaterialInterface* Parent, const FSimpleSurfaceParameters& Parameters) const
+{
+	const auto Key = KeysByMaterial.Find(Material);
+	return Key && Key->Parent == Parent && Key->Parameters == Parameters;
+}
+
+void USimpleSurfaceSubsystem::PurgeUnusedMaterials()
+{
+	bPurgePending = false;
+
+	for (auto It = MaterialPool.CreateIterator(); It; ++It)
+	{
+		if (It.Value().RefCount <= 0)
+		{
+			KeysByMaterial.Remove(It.Value().Material.Get());
+			It.RemoveCurrent();
+			DEC_DWORD_STAT(STAT_SimpleSurface_PooledMaterials);
+		}
+	}
+}
+
+void USimpleSurfaceSubsystem::RequestTexture(const TSoftObjectPtr<UTexture>& Texture, USimpleSurfaceComponent& Component)
+{
+	const FSoftObjectPath& TexturePath = Texture.ToSoftObjectPath();
+	if (TexturePath.IsNull())
+	{
+		return;
+	}
+
+	auto& Request = TextureRequests.FindOrAdd(TexturePath);
+	++Request.RefCount;
+
+	if (!Request.Handle.IsValid())
+	{
+		// The handle keeps the texture loaded for as long as any component uses it.
+		Request.Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(TexturePath,
+			FStreamableDelegate::CreateWeakLambda(this, [this, TexturePath] { OnTextureLoaded(TexturePath); }));
+	}
+
+	// Textures that are already resident are picked up by the component's next push.
+	if (!Request.Handle.IsValid() || !Request.Handle->HasLoadCompleted())
+	{
+		Request.WaitingComponents.Add(&Component);
+	}
+}
+
+void USimpleSurfaceSubsystem::ReleaseTexture(const TSoftObjectPtr<UTexture>& Texture)
+{
+	const FSoftObjectPath& TexturePath = Texture.ToSoftObjectPath();
+	auto Request = TextureRequests.Find(TexturePath);
+	if (!Request || --Request->RefCount > 0)
+	{
+		return;
+	}
+
+	// Materials still showing the texture keep it referenced until their surfaces push new parameters.  Only a load
+	// still in flight is cancelled; a completed one is released.
+	const auto& Handle = Request->Handle;
+	if (Handle.IsValid() && Handle->IsLoadingInProgress())
+	{
+		Handle->CancelHandle();
+	}
+	else if (Handle.IsValid())
+	{
+		Handle->ReleaseHandle();
+	}
+	TextureRequests.Remove(TexturePath);
+}
+
+void USimpleSurfaceSubsystem::OnTextureLoaded(FSoftObjectPath TexturePath)
+{
+	auto Request = TextureRequests.Find(TexturePath);
+	if (!Request)
+	{
+		return;
+	}
+
+	const auto Components = MoveTemp(Request->WaitingComponents);
+	Request->WaitingComponents.Reset();
+	for (const auto& Component : Components)
+	{
+		if (auto SafeComponent = Component.Get())
+		{
+			SafeComponent->MarkParametersDirty();
+		}
+	}
+}
+
+bool USimpleSurfaceSubsystem::IsCentralMonitoringEnabled()
+{
+	return GSimpleSurfaceCentralMonitoring;
+}
+
+void USimpleSurfaceSubsystem::StartMonitoring(USimpleSurfaceComponent& Component)
+{
+	if (MonitoredSurfaceIndexes.Contains(&Component))
+	{
+		return;
+	}
+
+	MonitoredSurfaceIndexes.Add(&Component, MonitoredSurfaces.Num());
+	MonitoredSurfaces.Add({ &Component, &Component });
+}
+
+void USimpleSurfaceSubsystem::StopMonitoring(USimpleSurfaceComponent& Component)
+{
+	int32 Index;
+	if (!MonitoredSurfaceIndexes.RemoveAndCopyValue(&Component, Index))
+	{
+		return;
+	}
+
+	MonitoredSurfaces.RemoveAtSwap(Index, EAllowShrinking::No);
+	if (MonitoredSurfaces.IsValidIndex(Index))
+	{
+		MonitoredSurfaceIndexes.Add(MonitoredSurfaces[Index].Key, Index);
+	}
+}
+
+void USimpleSurfaceSubsystem::StartDistanceLOD(USimpleSurfaceComponent& Component)
+{
+	if (LODSurfaceIndexes.Contains(&Component))
+	{
+		return;
+	}
+
+	LODSurfaceIndexes.Add(&Component, LODSurfaces.Num());
+	LODSurfaces.Add({ &Component, &Component });
+}
+
+void USimpleSurfaceSubsystem::StopDistanceLOD(USimpleSurfaceComponent& Component)
+{
+	int32 Index;
+	if (!LODSurfaceIndexes.RemoveAndCopyValue(&Component, Index))
+	{
+		return;
+	}
+
+	if (Component.bIsDistant)
+	{
+		Component.bIsDistant = false;
+		--NumDistantSurfaces;
+	}
+
+	LODSurfaces.RemoveAtSwap(Index, EAllowShrinking::No);
+	if (LODSurfaces.IsValidIndex(Index))
+	{
+		LODSurfaceIndexes.Add(LODSurfaces[Index].Key, Index);
+	}
+}
+
+void USimpleSurfaceSubsystem::DetectParallelChanges(const uint64 Frame, const int32 MaxChecks, TMap<TObjectKey<USimpleSurfaceComponent>, bool>& OutDetectedChanges) const
+{
+	// Collects the components in the order the round-robin pass will visit them, so that only those it has the budget
+	// for are checked.
+	TArray<USimpleSurfaceComponent*> DueComponents;
+	const int32 FirstIndex = MonitorCursor < MonitoredSurfaces.Num() ? MonitorCursor : 0;
+	for (int32 Visited = 0; Visited < MonitoredSurfaces.Num() && DueComponents.Num() < MaxChecks; ++Visited)
+	{
+		const auto& Surface = MonitoredSurfaces[(FirstIndex + Visited) % MonitoredSurfaces.Num()];
+		const auto Component = Surface.Component.Get();
+		if (Component && Surface.NextCheckFrame <= Frame && Component->IsActive())
+		{
+			DueComponents.Add(Component);
+		}
+	}
+
+	if (DueComponents.Num() < GSimpleSurfaceMonitorMinParallelChecks)
+	{
+		return;
+	}
+
+	// The components, their materials and the shared custom data material are read here, on the game thread; only the
+	// comparisons run in parallel.
+	TArray<USimpleSurfaceComponent::FChangeCheckInputs> Inputs;
+	Inputs.SetNum(DueComponents.Num());
+	for (int32 DueIndex = 0; DueIndex < DueComponents.Num(); ++DueIndex)
+	{
+		DueComponents[DueIndex]->GatherChangeCheckInputs(Inputs[DueIndex]);
+	}
+
+	TArray<TOptional<bool>> Results;
+	Results.SetNum(DueComponents.Num());
+	ParallelFor(DueComponents.Num(), [&DueComponents, &Inputs, &Results](const int32 DueIndex)
+	{
+		if (Inputs[DueIndex].bThreadSafe)
+		{
+			Results[DueIndex] = DueComponents[DueIndex]->DetectChanges(Inputs[DueIndex]);
+		}
+	});
+
+	OutDetectedChanges.Reserve(DueComponents.Num());
+	for (int32 DueIndex = 0; DueIndex < DueComponents.Num(); ++DueIndex)
+	{
+		if (Results[DueIndex].IsSet())
+		{
+			OutDetectedChanges.Add(TObjectKey<USimpleSurfaceComponent>(DueComponents[DueIndex]), Results[DueIndex].GetValue());
+		}
+	}
+}
+
+void USimpleSurfaceSubsystem::UpdateDistanceLOD()
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_UpdateDistanceLOD);
+
+	if (LODSurfaces.IsEmpty())
+	{
+		return;
+	}
+
+	// Distance LOD is off without the flat permutation, since distant surfaces would look no different.  Any surfaces
+	// still distant are brought back.
+	const bool bEnabled = GSimpleSurfaceLODDistance > 0.0f && GetPermutationMaterial(ESimpleSurfaceFeatures::None);
+
+	// Without a view there's nothing to be distant from; leave surfaces as they are.
+	const TArray<FVector>& ViewLocations = GetWorld()->ViewLocationsRenderedLastFrame;
+	if (ViewLocations.IsEmpty() && bEnabled)
+	{
+		return;
+	}
+
+	const double NearDistanceSquared = FMath::Square(GSimpleSurfaceLODDistance);
+	const double FarDistanceSquared = FMath::Square(GSimpleSurfaceLODDistance * (1.0f + FMath::Max(GSimpleSurfaceLODHysteresis, 0.0f)));
+
+	const int32 NumToEvaluate = FMath::Min(FMath::Max(GSimpleSurfaceLODSurfacesPerFrame, 1), LODSurfaces.Num());
+	for (int32 i = 0; i < NumToEvaluate; ++i)
+	{
+		LODCursor = LODCursor < LODSurfaces.Num() ? LODCursor : 0;
+		auto Component = LODSurfaces[LODCursor++].Component.Get();
+		const AActor* Owner = Component ? Component->GetOwner() : nullptr;
+		if (!Owner || Component->UsesCustomPrimitiveData())
+		{
+			continue;
+		}
+
+		// Animated surfaces are never distant, so a surface that starts animating while distant is brought back.
+		bool bIsDistant = false;
+		if (bEnabled && !Component->Animation.IsEnabled())
+		{
+			double DistanceSquared = TNumericLimits<double>::Max();
+			const FVector Location = Owner->GetActorLocation();
+			for (const FVector& ViewLocation : ViewLocations)
+			{
+				DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(ViewLocation, Location));
+			}
+
+			// Between the two distances, a surface keeps whichever state it's in.
+			bIsDistant = Component->bIsDistant ? DistanceSquared > NearDistanceSquared : DistanceSquared > FarDistanceSquared;
+		}
+
+		if (bIsDistant != Component->bIsDistant)
+		{
+			Component->bIsDistant = bIsDistant;
+			NumDistantSurfaces += bIsDistant ? 1 : -1;
+			Component->MarkParametersDirty();
+		}
+	}
+}
+
+void USimpleSurfaceSubsystem::QueueChangedComponent(USimpleSurfaceComponent& Component)
+{
+	ChangedComponents.Add(&Component);
+}
+
+void USimpleSurfaceSubsystem::QueueParameterFlush(USimpleSurfaceComponent& Component)
+{
+	DirtyParameterComponents.Add(&Component);
+}
+
+void USimpleSurfaceSubsystem::QueueRulesUpdate(ASimpleSurfaceRules& Rules)
+{
+	PendingRuleSets.AddUnique(&Rules);
+}
+
+void USimpleSurfaceSubsystem::FlushRules()
+{
+	const auto RuleSetsToFlush = MoveTemp(PendingRuleSets);
+	PendingRuleSets.Reset();
+	for (const auto& RuleSet : RuleSetsToFlush)
+	{
+		if (auto SafeRuleSet = RuleSet.Get())
+		{
+			SafeRuleSet->FlushPendingRules();
+		}
+	}
+}
+
+void USimpleSurfaceSubsystem::QueueOrphanedCatalog(AActor& Owner, const FSimpleSurfaceMeshCatalog& Catalog)
+{
+	OrphanedCatalogs.Emplace(&Owner, Catalog);
+}
+
+void USimpleSurfaceSubsystem::FlushOrphanedCatalogs()
+{
+	if (OrphanedCatalogs.IsEmpty())
+	{
+		return;
+	}
+
+	const auto CatalogsToFlush = MoveTemp(OrphanedCatalogs);
+	OrphanedCatalogs.Reset();
+	for (const auto& [WeakOwner, Catalog] : CatalogsToFlush)
+	{
+		// A replacement that registered took the catalog over, along with the meshes.
+		const AActor* Owner = WeakOwner.Get();
+		const auto Replacement = Owner ? Owner->FindComponentByClass<USimpleSurfaceComponent>() : nullptr;
+		if (!Owner || (Replacement && Replacement->IsRegistered()))
+		{
+			continue;
+		}
+
+		// Keep the loaded materials referenced until they've been assigned.
+		TArray<FSoftObjectPath> UnloadedMaterials;
+		Catalog.CollectUnloadedMaterials(UnloadedMaterials);
+		TSharedPtr<FStreamableHandle> Handle;
+		if (!UnloadedMaterials.IsEmpty())
+		{
+			Handle = UAssetManager::GetStreamableManager().RequestSyncLoad(MoveTemp(UnloadedMaterials));
+		}
+
+		for (const auto& Entry : Catalog.Entries)
+		{
+			if (auto MeshComponent = Entry.Component.Get())
+			{
+				Catalog.ApplyMaterials(Entry, *MeshComponent);
+			}
+		}
+
+		if (Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+}
+
+void USimpleSurfaceSubsystem::FlushSurfaceParameters()
+{
+	if (DirtyParameterComponents.IsEmpty())
+	{
+		return;
+	}
+
+	// Components that were flushed explicitly in the meantime are no longer dirty, and are skipped.
+	const auto ComponentsToFlush = MoveTemp(DirtyParameterComponents);
+	DirtyParameterComponents.Reset();
+	for (const auto& DirtyComponent : ComponentsToFlush)
+	{
+		if (auto SafeComponent = DirtyComponent.Get())
+		{
+			SafeComponent->FlushSurfaceParameters();
+		}
+	}
+}
+
+void USimpleSurfaceSubsystem::MonitorComponents()
+{
+	SIMPLESURFACE_SCOPE(STAT_SimpleSurface_MonitorComponents);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double Deadline = StartTime + GSimpleSurfaceMonitorBudgetMs / 1000.0;
+
+	const FSimpleSurfaceMonitorStats PreviousFrameStats = LastFrameStats;
+	LastFrameStats = FSimpleSurfaceMonitorStats();
+	LastFrameStats.NumMonitored = MonitoredSurfaces.Num();
+
+	// Event-driven components only queue themselves when something changed, so process them all regardless of budget.
+	// Processing may queue components again, for the next frame.
+	const auto ComponentsToProcess = MoveTemp(ChangedComponents);
+	ChangedComponents.Reset();
+	for (const auto& ChangedComponent : ComponentsToProcess)
+	{
+		auto SafeComponent = ChangedComponent.Get();
+		if (SafeComponent && SafeComponent->ProcessPendingChanges())
+		{
+			++LastFrameStats.NumReapplied;
+		}
+	}
+
+	const uint64 Frame = GFrameCounter;
+	const int32 MaxInterval = FMath::Max(GSimpleSurfaceMonitorMaxInterval, 1);
+	const int32 IdleChecksPerBackoff = FMath::Max(GSimpleSurfaceMonitorIdleChecksPerBackoff, 1);
+
+	// Detection only reads the actors' components, so with enough components due it runs in parallel, leaving the game
+	// thread only the re-applies.  Components with meshes whose identity can't be resolved off the game thread are
+	// checked there as usual.  When the previous frame ran out of budget, only as many components as it managed to
+	// check in the budget are checked in advance.
+	TMap<TObjectKey<USimpleSurfaceComponent>, bool> DetectedChanges;
+	if (GSimpleSurfaceMonitorParallel && FApp::ShouldUseThreadingForPerformance())
+	{
+		int32 MaxChecks = MonitoredSurfaces.Num();
+		if (PreviousFrameStats.NumChecked > 0 && PreviousFrameStats.ElapsedMilliseconds >= GSimpleSurfaceMonitorBudgetMs)
+		{
+			const double ChecksInBudget = PreviousFrameStats.NumChecked * GSimpleSurfaceMonitorBudgetMs / PreviousFrameStats.ElapsedMilliseconds;
+			MaxChecks = FMath::Clamp(FMath::CeilToInt32(ChecksInBudget), 1, MaxChecks);
+		}
+		DetectParallelChanges(Frame, MaxChecks, DetectedChanges);
+	}
+
+	for (int32 Visited = 0; Visited < MonitoredSurfaces.Num(); ++Visited)
+	{
+		if (MonitorCursor >= MonitoredSurfaces.Num())
+		{
+			MonitorCursor = 0;
+		}
+		const int32 Index = MonitorCursor++;
+
+		auto Component = MonitoredSurfaces[Index].Component.Get();
+		if (!Component || MonitoredSurfaces[Index].NextCheckFrame > Frame || !Component->IsActive())
+		{
+			continue;
+		}
+
+		++LastFrameStats.NumChecked;
+		// Earlier re-applies in this loop may have moved surfaces since detection, so its results are looked up by component.
+		const TObjectKey<USimpleSurfaceComponent> Key = MonitoredSurfaces[Index].Key;
+		const bool* bChangeDetected = DetectedChanges.Find(Key);
+		const bool bChanged = Component->PollForChanges(bChangeDetected ? TOptional<bool>(*bChangeDetected) : TOptional<bool>());
+
+		if (bChanged)
+		{
+			++LastFrameStats.NumReapplied;
+		}
+
+		// Re-applying may start or stop monitoring components, moving others, or stop monitoring this one.
+		if (const int32* CurrentIndex = MonitoredSurfaceIndexes.Find(Key))
+		{
+			// Back off exponentially while a component stays idle; check it every frame again as soon as it changes.
+			auto& Surface = MonitoredSurfaces[*CurrentIndex];
+			Surface.IdleChecks = bChanged ? 0 : Surface.IdleChecks + 1;
+			const int32 Interval = FMath::Min(1 << FMath::Min(Surface.IdleChecks / IdleChecksPerBackoff, 30), MaxInterval);
+			Surface.NextCheckFrame = Frame + Interval;
+		}
+
+		if (FPlatformTime::Seconds() >= Deadline)
+		{
+			break;
+		}
+	}
+
+	LastFrameStats.ElapsedMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	SET_DWORD_STAT(STAT_SimpleSurface_ComponentsChecked, LastFrameStats.NumChecked);
+}
@@ -0,0 +1,154 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceTypes.h"
+
+#include "Math/RandomStream.h"
+
+namespace SimpleSurfaceParameterNames
+{
+	const FName Color(TEXT("Color"));
+	const FName Glow(TEXT("Glow"));
+	const FName WaxinessMetalness(TEXT("Waxiness / Metalness"));
+	const FName ShininessRoughness(TEXT("Shininess / Roughness"));
+	const FName Texture(TEXT("Texture"));
+	const FName TextureIntensity(TEXT("Texture Intensity"));
+	const FName TextureScale(TEXT("Texture Scale"));
+	const FName ShowGrid(TEXT("Show Grid"));
+	const FName GridSize(TEXT("Grid Size"));
+	const FName SubGridNumber(TEXT("Sub Grid Number"));
+	const FName ObjectAligned(TEXT("ObjectAligned"));
+	const FName AnimationMode(TEXT("Animation Mode"));
+	const FName AnimationTarget(TEXT("Animation Target"));
+	const FName AnimationTiming(TEXT("Animation Timing"));
+}
+
+uint32 GetTypeHash(const FSimpleSurfaceGridParams& Params)
+{
+	uint32 Hash = GetTypeHash(Params.GridSize);
+	Hash = HashCombineFast(Hash, GetTypeHash(Params.SubGridDivisions));
+	Hash = HashCombineFast(Hash, GetTypeHash(Params.bIsObjectAligned));
+	return Hash;
+}
+
+bool FSimpleSurfaceAnimation::IsPlaying(const float WorldTime) const
+{
+	switch (Mode)
+	{
+	case ESimpleSurfaceAnimationMode::Pulse:
+		return NumPulses == 0 || WorldTime < StartTime + Duration * NumPulses;
+	case ESimpleSurfaceAnimationMode::Blend:
+		return WorldTime < StartTime + Duration;
+	default:
+		return false;
+	}
+}
+
+uint32 GetTypeHash(const FSimpleSurfaceAnimation& Animation)
+{
+	uint32 Hash = GetTypeHash(Animation.Mode);
+	Hash = HashCombineFast(Hash, GetTypeHash(Animation.TargetColor));
+	Hash = HashCombineFast(Hash, GetTypeHash(Animation.TargetGlow));
+	Hash = HashCombineFast(Hash, GetTypeHash(Animation.Duration));
+	Hash = HashCombineFast(Hash, GetTypeHash(Animation.NumPulses));
+	Hash = HashCombineFast(Hash, GetTypeHash(Animation.Easing));
+	Hash = HashCombineFast(Hash, GetTypeHash(Animation.StartTime));
+	return Hash;
+}
+
+ESimpleSurfaceFeatures FSimpleSurfaceParameters::GetFeatures() const
+{
+	ESimpleSurfaceFeatures Features = ESimpleSurfaceFeatures::None;
+	if (ShowGrid != 0.0f)
+	{
+		Features |= ESimpleSurfaceFeatures::Grid;
+		if (GridParams.bIsObjectAligned)
+		{
+			Features |= ESimpleSurfaceFeatures::ObjectAligned;
+		}
+	}
+	if (TextureIntensity > 0.0f)
+	{
+		Features |= ESimpleSurfaceFeatures::Texture;
+	}
+	if (Glow > 0.0f || (Animation.IsEnabled() && Animation.TargetGlow > 0.0f))
+	{
+		Features |= ESimpleSurfaceFeatures::Glow;
+	}
+	return Features;
+}
+
+uint32 GetTypeHash(const FSimpleSurfaceParameters& Parameters)
+{
+	uint32 Hash = GetTypeHash(Parameters.Color);
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.Glow));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.ShininessRoughness));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.WaxinessMetalness));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.TextureIntensity));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.TextureScale));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.Texture));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.ShowGrid));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.GridParams));
+	Hash = HashCombineFast(Hash, GetTypeHash(Parameters.Animation));
+	return Hash;
+}
+
+FSimpleSurfaceParameters FSimpleSurfaceInstanceVariation::Vary(const FSimpleSurfaceParameters& Base, const int32 InstanceIndex) const
+{
+	FSimpleSurfaceParameters Result = Base;
+
+	if (Source == ESimpleSurfaceVariationSource::None)
+	{
+		return Result;
+	}
+
+	if (Source == ESimpleSurfaceVariationSource::Explicit)
+	{
+		if (InstanceColors.IsValidIndex(InstanceIndex))
+		{
+			Result.Color = InstanceColors[InstanceIndex];
+		}
+		if (InstanceRoughness.IsValidIndex(InstanceIndex))
+		{
+			Result.ShininessRoughness = InstanceRoughness[InstanceIndex];
+		}
+		if (InstanceGridSizes.IsValidIndex(InstanceIndex))
+		{
+			Result.GridParams.GridSize = InstanceGridSizes[InstanceIndex];
+		}
+		return Result;
+	}
+
+	// The same seed and instance always produce the same surface, so instances don't change when others are added.
+	FRandomStream Stream(HashCombineFast(GetTypeHash(Seed), GetTypeHash(InstanceIndex)));
+
+	if (Source == ESimpleSurfaceVariationSource::Palette)
+	{
+		if (Palette.Num() > 0)
+		{
+			Result.Color = Palette[Stream.RandHelper(Palette.Num())];
+		}
+	}
+	else
+	{
+		FLinearColor HSV = FLinearColor(Base.Color).LinearRGBToHSV();
+		HSV.R = FMath::Fmod(HSV.R + Stream.FRandRange(-HueVariation, HueVariation) + 360.0f, 360.0f);
+		HSV.B = FMath::Clamp(HSV.B * (1.0f + Stream.FRandRange(-BrightnessVariation, BrightnessVariation)), 0.0f, 1.0f);
+		Result.Color = HSV.HSVToLinearRGB().ToFColor(true);
+	}
+
+	Result.ShininessRoughness = FMath::Clamp(Base.ShininessRoughness + Stream.FRandRange(-RoughnessVariation, RoughnessVariation), 0.0f, 1.0f);
+	Result.GridParams.GridSize = Base.GridParams.GridSize * (1.0f + Stream.FRandRange(-GridSizeVariation, GridSizeVariation));
+
+	return Result;
+}
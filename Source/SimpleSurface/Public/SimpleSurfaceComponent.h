@@ -14,8 +14,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ComponentInstanceDataCache.h"
 #include "Components/ActorComponent.h"
 #include "Components/DynamicMeshComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
+#include "SimpleSurfaceCustomData.h"
+#include "SimpleSurfaceMeshCatalog.h"
+#include "SimpleSurfaceParameterCache.h"
+#include "SimpleSurfaceTypes.h"
 #include "UObject/UObjectGlobals.h"
 
 #include "SimpleSurfaceComponent.generated.h"
@@ -24,93 +31,89 @@ class UMaterialInterface;
 class UMaterialInstanceDynamic;
 class UMaterialInstance;
 class UTexture2D;
+class UInstancedStaticMeshComponent;
 class UMeshComponent;
+class USimpleSurfacePreset;
+class USimpleSurfaceSubsystem;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSimpleSurface, Log, All);
 
-using ComponentMaterialMap = TMap<TObjectPtr<UMeshComponent>, TMap<int32, TObjectPtr<UMaterialInterface>>>;
-
-USTRUCT(BlueprintType)
-struct FSimpleSurfaceGridParams
-{
-	GENERATED_BODY()
-
-	FSimpleSurfaceGridParams() = default;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=-0.1f, ClampMax=1000000.0f, UIMin=10.0f, UIMax=1000.0f))
-	float GridSize = 100.0f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=1.0f, ClampMax=100.0f, UIMin=1.0f, UIMax=100.0f))
-	float SubGridDivisions = 5.0f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	bool bIsObjectAligned = false;
-};
-
 /**
- * Captures the mesh and materials of a UMeshComponent for later restoration, e.g. if SimpleSurfaceComponent is removed.
+ * How a SimpleSurfaceComponent notices changes to its actor's mesh components and materials.
  */
-USTRUCT()
-struct FMeshCatalogRecord
+UENUM()
+enum class ESimpleSurfaceChangeDetection : uint8
 {
-	GENERATED_BODY()
-
-	FMeshCatalogRecord();
-
-	FMeshCatalogRecord(UMeshComponent& Component, const TArray<const TSoftClassPtr<UMaterialInterface>>& Ex);
-
 	/**
-	 * Updates this record to reflect the specified @see UMeshComponent.
+	 * Checks the actor's mesh components and materials every frame.  Catches every kind of change, at a per-frame cost.
 	 */
-	void UpdateRecord(UMeshComponent& Component);
+	Polling,
 
-	UPROPERTY()
-	TArray<int32> IndexPath;
-	
 	/**
-	 * Returns an array of indexes that represent the path to the component from the root component.
+	 * Listens for component, mesh and material change notifications and only re-applies SimpleSurface when one arrives.
+	 * The component does not tick in this mode.
 	 */
-	static TArray<int32> GetIndexPath(UMeshComponent& MeshComponent);
+	EventDriven
+};
 
+/**
+ * How a SimpleSurfaceComponent gets its parameters to the GPU.
+ */
+UENUM()
+enum class ESimpleSurfaceRenderMode : uint8
+{
 	/**
-	 * Uses @see IndexPath to locate a component on the specified actor.  Useful for remapping a record to a new actor, e.g. after duplication. 
+	 * Meshes use a material instance carrying this surface's parameters.  Instances are shared by surfaces with identical parameters.
 	 */
-	UMeshComponent* LocateComponent(const AActor &Actor);
+	MaterialInstance,
 
 	/**
-	 * Applies the materials captured by this record to the specified UMeshComponent.
+	 * Meshes all use one static material, and this surface's parameters are written to each mesh's custom primitive data.
+	 * Editing parameters doesn't touch any material, and meshes can batch and auto-instance across actors.
+	 * Surfaces with a texture override still use a material instance.
 	 */
-	void ApplyMaterials(UMeshComponent& MeshComponent) const;
+	CustomPrimitiveData
+};
 
-	/**
-	 * Accumulates the materials used by the specified UMeshComponent into this record's MaterialsBySlot.
-	 * Skips any materials matching the classes in ExcludedMaterialClasses.
-	 */
-	void UpdateMaterialsBySlot(const UMeshComponent& MeshComponent);
+/**
+ * The values of a SimpleSurfaceComponent that can override its preset's.
+ */
+UENUM(meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class ESimpleSurfacePresetField : int32
+{
+	None = 0 UMETA(Hidden),
+	Color = 1 << 0,
+	Glow = 1 << 1,
+	ShininessRoughness = 1 << 2 UMETA(DisplayName = "Shininess / Roughness"),
+	WaxinessMetalness = 1 << 3 UMETA(DisplayName = "Waxiness / Metalness"),
+	TextureIntensity = 1 << 4,
+	TextureScale = 1 << 5,
+	Texture = 1 << 6 UMETA(DisplayName = "Texture Override"),
+	ShowGrid = 1 << 7 UMETA(DisplayName = "Grid Intensity"),
+	GridParams = 1 << 8 UMETA(DisplayName = "Grid Tweaks")
+};
+ENUM_CLASS_FLAGS(ESimpleSurfacePresetField);
 
-	/**
-	 * Returns true if the mesh presented by the specified UMeshComponent is the same as the mesh presented by the mesh component that this record was created from.
-	 */
-	bool MeshEquals(UMeshComponent& Component) const;
+/**
+ * Captures the mesh and materials of a UMeshComponent for later restoration.
+ * Only kept so catalogs saved by older versions can be loaded; @see FSimpleSurfaceMeshCatalog.
+ */
+USTRUCT()
+struct FMeshCatalogRecord
+{
+	GENERATED_BODY()
 
-	bool operator==(const FMeshCatalogRecord& Other) const;
+	UPROPERTY()
+	TArray<int32> IndexPath;
 
-	/**
-	 * A hash of the mesh presented by MeshComponent.  Used to determine if an existing MeshComponent's mesh changed.
-	 */
 	UPROPERTY()
 	uint32 MeshHash = -1;
 
-	/**
-	 * A map of material slot indexes to materials.
-	 */
 	UPROPERTY()
 	TArray<TSoftObjectPtr<UMaterialInterface>> MaterialsBySlot;
 
 	UPROPERTY()
-	TArray<const TSoftClassPtr<UMaterialInterface>> ExcludedMaterialClasses;
-
-	static uint32 GetMeshHash(UMeshComponent* MeshComponent);
+	TArray<TSoftClassPtr<UMaterialInterface>> ExcludedMaterialClasses;
 };
 	
 /**
@@ -121,8 +124,6 @@ class SIMPLESURFACE_API USimpleSurfaceComponent : public UActorComponent
 {
 private:
 	GENERATED_BODY()
-
-	ComponentMaterialMap TransientComponentMaterialMap;
 	
 public:
 	USimpleSurfaceComponent(FObjectInitializer const& ObjectInitializer);
@@ -132,6 +133,8 @@ public:
 	 */
 	void ApplyAll();
 
+	virtual void PostLoad() override;
+
 	/**
 	 * Handle the component's being turned on.
 	 */
@@ -144,6 +147,30 @@ public:
 
 	virtual void DestroyComponent(bool bPromoteChildren = false) override;
 
+	/**
+	 * Hands the mesh catalog to the component that replaces this one when the owner's construction script reruns.
+	 */
+	virtual TStructOnScope<FActorComponentInstanceData> GetComponentInstanceData() const override;
+
+	/**
+	 * Finishes restoring original materials immediately, if a restore is waiting for materials to load.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "🎨 Simple Surface")
+	void FlushMaterialRestore();
+
+	/**
+	 * A shared surface to use instead of this component's own values.  Components that don't override any of the
+	 * preset's values render through the preset's material instance, so editing the preset updates them all at once.
+	 */
+	UPROPERTY(DisplayName = "📦 Preset", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadWrite, Setter = SetParameter_Preset)
+	TObjectPtr<USimpleSurfacePreset> Preset;
+
+	/**
+	 * The values of this component that are used instead of its preset's.  Setting a value overrides it.
+	 */
+	UPROPERTY(DisplayName = "📦 Preset Overrides", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadWrite, Setter = SetParameter_PresetOverrides, meta = (Bitmask, BitmaskEnum = "/Script/SimpleSurface.ESimpleSurfacePresetField", EditCondition = "Preset != nullptr", EditConditionHides))
+	int32 PresetOverrides = 0;
+
 	UPROPERTY(DisplayName = "🖌️ Color", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadWrite, Setter = SetParameter_Color, meta = (HideAlphaChannel))
 	FColor Color = FColor::FromHex("D84DC2");
 
@@ -169,25 +196,216 @@ public:
 	float TextureScale = 1.0f;
 
 	/**
-	 * An optional texture to use as a normal map instead of the built-in texture.
+	 * An optional texture to use as a normal map instead of the built-in texture.  It's streamed in when the surface is
+	 * registered, and the built-in texture is shown until it loads.
 	 */
 	UPROPERTY(DisplayName = "🧱 Texture Override", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadWrite, Setter = SetParameter_Texture, meta = (DisplayPriority = 30, DisplayAfter = Appearance))
-	TObjectPtr<UTexture> Texture;
+	TSoftObjectPtr<UTexture> Texture;
 
 	UPROPERTY(DisplayName = "📐 Grid Intensity", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadWrite, Setter = SetParameter_ShowGrid, meta = (ClampMin = -1.0f, ClampMax = 1.0f, DisplayPriority = 40, DisplayAfter = Appearance))
 	float ShowGrid = 0.0f;
 
 	UPROPERTY(DisplayName = "📐 Grid Tweaks", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadWrite, Setter = SetParameter_GridSettings, meta = (DisplayPriority = 50, DisplayAfter = Appearance))
 	FSimpleSurfaceGridParams GridParams;
+
+	/**
+	 * Varies the surface across the instances of the actor's instanced static meshes, using per-instance custom data.
+	 * While enabled, SimpleSurface owns those meshes' per-instance custom data.
+	 */
+	UPROPERTY(DisplayName = "🎲 Instance Variation", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadWrite, Setter = SetParameter_InstanceVariation, meta = (DisplayPriority = 60, DisplayAfter = Appearance))
+	FSimpleSurfaceInstanceVariation InstanceVariation;
+
+	/**
+	 * The animation currently applied to the surface's color and glow.  @see PlayAnimation
+	 */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "🎨 Simple Surface")
+	FSimpleSurfaceAnimation Animation;
+
+	/**
+	 * How changes to the actor's meshes and materials are detected.  Polling catches everything but costs time every frame;
+	 * event-driven detection costs nothing while the actor is idle.
+	 */
+	UPROPERTY(DisplayName = "Change Detection", Category = "🎨 Simple Surface", EditAnywhere, AdvancedDisplay)
+	ESimpleSurfaceChangeDetection ChangeDetection = ESimpleSurfaceChangeDetection::Polling;
+
+	/**
+	 * How parameters reach the GPU.  Custom primitive data lets every SimpleSurface mesh share one material.
+	 */
+	UPROPERTY(DisplayName = "Render Mode", Category = "🎨 Simple Surface", EditAnywhere, AdvancedDisplay)
+	ESimpleSurfaceRenderMode RenderMode = ESimpleSurfaceRenderMode::MaterialInstance;
+
+	/**
+	 * Whether this surface switches to flat color beyond SimpleSurface.LOD.Distance.  Turn off for surfaces whose grid or
+	 * texture must read from afar.
+	 */
+	UPROPERTY(DisplayName = "Use Distance LOD", Category = "🎨 Simple Surface", EditAnywhere, AdvancedDisplay)
+	bool bUseDistanceLOD = true;
+
+	/**
+	 * A material instance asset carrying this surface's parameters, created by the SimpleSurfaceBake commandlet.
+	 * When cooking, it's assigned to the actor's meshes and this component is left out of the cooked package,
+	 * unless the surface was edited since it was baked.
+	 */
+	UPROPERTY(DisplayName = "Baked Material", Category = "🎨 Simple Surface", VisibleAnywhere, AdvancedDisplay)
+	TObjectPtr<UMaterialInterface> BakedMaterial;
+
+	/**
+	 * The parameters BakedMaterial was created with.
+	 */
+	UPROPERTY()
+	FSimpleSurfaceParameters BakedParameters;
+
+	/**
+	 * Returns true if this surface can be baked into a material instance asset.  Surfaces varying across instances or animating can't.
+	 */
+	bool CanBake() const;
+
+	/**
+	 * Returns true if BakedMaterial reflects the surface's current parameters.
+	 */
+	bool HasCurrentBake() const;
+
+	/**
+	 * The material this surface's instances are created from: the permutation of the SimpleSurface material matching
+	 * the features its parameters use, or the base material if there isn't one.
+	 */
+	UMaterialInterface* GetParentMaterial() const;
+
+	/**
+	 * Returns the texture override in effect: this component's, or its preset's.
+	 */
+	TSoftObjectPtr<UTexture> GetTextureOverride() const;
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+#endif
+	virtual bool NeedsLoadForClient() const override;
+	virtual bool NeedsLoadForServer() const override;
 	
 	/**
 	 * Monitors the actor's components and materials for changes and re-applies SimpleSurface if necessary.
+	 * Only ticks when the world's SimpleSurface subsystem isn't monitoring the component instead.
 	 */
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
 	                           FActorComponentTickFunction* ThisTickFunction) override;
 
+	/**
+	 * Pushes any changed parameters, then checks the actor's components and materials for changes and re-applies
+	 * SimpleSurface if necessary.  Returns true if SimpleSurface was re-applied.
+	 *
+	 * @param bChangeDetected The result of MonitorForChanges(), if it already ran, e.g. in parallel with other components'.
+	 */
+	bool PollForChanges(TOptional<bool> bChangeDetected = {});
+
 	virtual void OnRegister() override;
 
+	virtual void OnUnregister() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+#endif
+
+	/**
+	 * Tells the component that the actor's mesh components or materials changed, so SimpleSurface is re-applied on the next frame.
+	 * Only needed with event-driven change detection, for changes that don't raise a notification of their own,
+	 * e.g. mesh components without collision added at runtime.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "🎨 Simple Surface")
+	void NotifyMeshComponentsChanged();
+
+	/**
+	 * Pushes parameters set since the last push to the material or custom data right away.  Otherwise, parameters set
+	 * through the setters are pushed once, at the end of the frame, however many were set.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "🎨 Simple Surface")
+	void FlushSurfaceParameters();
+
+	/**
+	 * Starts animating the surface's color and glow from now.  The animation is pushed to the material once and
+	 * evaluated there, so it costs nothing per frame; use this rather than setting Color or Glow every tick.
+	 * Surfaces rendered with custom primitive data switch to a material instance while animated.
+	 *
+	 * Returns false, leaving the surface as it is, if its material doesn't evaluate animations.  @see SupportsAnimation
+	 */
+	UFUNCTION(BlueprintCallable, Category = "🎨 Simple Surface")
+	bool PlayAnimation(const FSimpleSurfaceAnimation& InAnimation);
+
+	/**
+	 * Stops the current animation, returning the surface to its own color and glow.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "🎨 Simple Surface")
+	void StopAnimation();
+
+	/**
+	 * Returns true if an animation is still changing the surface's appearance.  A finished blend holds its target
+	 * until stopped, but is no longer playing.
+	 */
+	UFUNCTION(BlueprintPure, Category = "🎨 Simple Surface")
+	bool IsAnimationPlaying() const;
+
+	/**
+	 * Returns true if the SimpleSurface material reads the "Animation Mode", "Animation Target" and "Animation Timing"
+	 * parameters.  Without them an animation would have no visible effect, so PlayAnimation() doesn't start one.
+	 */
+	UFUNCTION(BlueprintPure, Category = "🎨 Simple Surface")
+	bool SupportsAnimation() const;
+
+	/**
+	 * Returns the values this component pushes to the SimpleSurface material.
+	 */
+	FSimpleSurfaceParameters GetSurfaceParameters() const;
+
+	/**
+	 * Returns true while this component is assigning or restoring materials or writing custom data, so the change
+	 * notifications raised meanwhile are its own.
+	 */
+	bool IsApplyingSurface() const { return bIsApplyingSurface; }
+
+	/**
+	 * Returns the record of the materials SimpleSurface replaced, which are restored when it's removed.
+	 */
+	const FSimpleSurfaceMeshCatalog& GetMeshCatalog() const { return MeshCatalog; }
+
+	/**
+	 * Returns this component's material instance, which may be pooled or a preset's, or null if it renders through
+	 * custom primitive data.
+	 */
+	UMaterialInstanceDynamic* GetSimpleSurfaceMaterial() const { return SimpleSurfaceMaterial; }
+
+	/**
+	 * Returns the time spent checking for and handling changes since the last reset, in cycles.
+	 */
+	uint64 GetMonitoringCycles() const { return MonitoringCycles; }
+	void ResetMonitoringCycles() { MonitoringCycles = 0; }
+
+	/**
+	 * Adopts a catalog of the actor's mesh components captured ahead of registering, e.g. in parallel for many actors,
+	 * so registering only assigns materials.  Call before registering.
+	 *
+	 * @param NumMeshComponents The number of mesh components the actor had when the catalog was captured.
+	 */
+	void InitializeFromCapturedCatalog(FSimpleSurfaceMeshCatalog&& InMeshCatalog, int32 NumMeshComponents);
+
+	/**
+	 * Restores the captured materials now, waiting for any that need loading, e.g. so the restore is part of an editor
+	 * transaction.  Destroying the component afterwards doesn't hand the meshes to a replacement.
+	 */
+	void RestoreImmediately();
+
+	/**
+	 * Updates this component's internal state to capture the actor's current mesh components and their assigned materials,
+	 * so they can be restored later if the component is deleted or deactivated.
+	 *
+	 * This also works across sessions. :)
+	 *
+	 * @see TryRestoreMaterials
+	 * 
+	 * @remarks Each captured component is stored with its mesh hash, its materials and its "path" from the root component,
+	 *   used when duplicating actors and their components.  @see FSimpleSurfaceMeshCatalog
+	 */
+	void UpdateMeshCatalog();
+
 private:
 	UPROPERTY(DuplicateTransient)
 	TObjectPtr<UMaterialInstanceDynamic> SimpleSurfaceMaterial;
@@ -199,61 +417,356 @@ private:
 	 * Keeps a record of materials applied to mesh components, so they can be restored if the component is deleted or deactivated.
 	 */
 	UPROPERTY()
-	TMap<TSoftObjectPtr<UMeshComponent>, FMeshCatalogRecord> CapturedMeshCatalog;
+	FSimpleSurfaceMeshCatalog MeshCatalog;
+
+	UPROPERTY()
+	TMap<TSoftObjectPtr<UMeshComponent>, FMeshCatalogRecord> CapturedMeshCatalog_DEPRECATED;
 		
 	int32 CapturedMeshComponentCount;
+
+	/**
+	 * True while this component is assigning or restoring materials, so that the notifications it raises itself are ignored.
+	 */
+	bool bIsApplyingSurface = false;
+
+	/**
+	 * True when a change notification arrived that hasn't been processed yet.
+	 */
+	bool bSurfaceDirty = false;
+
+	/**
+	 * True when parameters were set that haven't been pushed yet.
+	 */
+	bool bParametersDirty = false;
+
+	/**
+	 * True while this component is being cooked with a current bake, so it's left out of the cooked package.
+	 */
+	bool bStrippedForCook = false;
+
+#if WITH_EDITOR
+	/**
+	 * The mesh components' own material overrides, while the baked material stands in for them in a cooked save.
+	 */
+	TArray<TPair<TWeakObjectPtr<UMeshComponent>, TArray<TObjectPtr<UMaterialInterface>>>> OverridesDuringCook;
+	FDelegateHandle PackageSavedHandle;
+
+	/**
+	 * Gives the mesh components back the overrides the baked material stood in for, once their package is saved.
+	 */
+	void RestoreOverridesAfterCook();
+	void HandlePackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext);
+#endif
+
+	/**
+	 * True once SimpleSurface was applied to the owner's meshes in this session.  Registering again, e.g. when the
+	 * owner's construction script reruns, then only revisits the meshes that changed.
+	 */
+	bool bHasAppliedSurface = false;
+
+	/**
+	 * True once this component's catalog was handed to a replacement.  Destroying it then leaves the meshes to the
+	 * replacement rather than restoring their materials, only for the replacement to apply SimpleSurface again.
+	 */
+	mutable bool bHandedOffCatalog = false;
+
+	/**
+	 * True when the mesh catalog was captured ahead of registering, e.g. for a bulk apply, so registering only assigns
+	 * materials.
+	 */
+	bool bIsCatalogPrepared = false;
+
+	/**
+	 * True while the subsystem considers this surface far enough away to render as flat color.
+	 */
+	bool bIsDistant = false;
+
+	/**
+	 * Starts or stops distance LOD evaluation by the subsystem, as bUseDistanceLOD dictates.
+	 */
+	void UpdateDistanceLOD();
+
+	/**
+	 * The material this component's own or pooled instance is created from: GetParentMaterial(), or the flat-color
+	 * permutation while the surface is distant.
+	 */
+	UMaterialInterface* GetInstanceParentMaterial() const;
+
+	FTSTicker::FDelegateHandle PendingChangesTickerHandle;
+
+	/**
+	 * Time spent checking for and handling changes since it was last reported by SimpleSurface.Stats, in cycles.
+	 */
+	uint64 MonitoringCycles = 0;
+
+	/**
+	 * The batch of original materials being loaded for a restore, if any.
+	 */
+	TSharedPtr<FStreamableHandle> PendingRestoreHandle;
+
+	/**
+	 * The texture override this component asked the subsystem to stream in, if any.
+	 */
+	TSoftObjectPtr<UTexture> RequestedTexture;
+
+	/**
+	 * Requests the current texture override, and gives up the previous one.
+	 */
+	void UpdateTextureRequest();
+
+	/**
+	 * The preset whose changes this component is listening for.
+	 */
+	TWeakObjectPtr<USimpleSurfacePreset> SubscribedPreset;
+	FDelegateHandle PresetChangedHandle;
+
+	/**
+	 * Listens for changes to the current preset, and stops listening to the previous one.
+	 */
+	void UpdatePresetSubscription();
+	void OnPresetChanged(bool bFeaturesChanged);
+
+	/**
+	 * Returns true if the specified value comes from this component rather than its preset.
+	 */
+	bool OverridesPreset(ESimpleSurfacePresetField Field) const;
+
+	/**
+	 * Makes the specified value come from this component rather than its preset, if it has one.
+	 */
+	void OverridePreset(ESimpleSurfacePresetField Field);
+
+	/**
+	 * Returns true if this component renders through its preset's material instance.
+	 */
+	bool UsesPresetMaterial() const;
+
+	/**
+	 * Remembers what was last pushed to SimpleSurfaceMaterial, so unchanged parameters aren't pushed again.
+	 */
+	FSimpleSurfaceParameterCache ParameterCache;
+
+	/**
+	 * The parameters last written to the meshes' custom primitive data, if any were.
+	 */
+	TOptional<FSimpleSurfaceParameters> CustomDataParameters;
+
+	/**
+	 * The instanced meshes whose per-instance custom data was last written, and how many instances each had at the time.
+	 */
+	TMap<TWeakObjectPtr<UInstancedStaticMeshComponent>, int32> VariedInstanceCounts;
+
+	/**
+	 * Each varied instanced mesh's own per-instance custom data from before variation took it over, to restore when
+	 * variation stops.
+	 */
+	TMap<TWeakObjectPtr<UInstancedStaticMeshComponent>, SimpleSurfaceCustomData::FInstanceData> InstanceDataBeforeVariation;
+
+	/**
+	 * The parameters instance variation was last derived from.
+	 */
+	TOptional<FSimpleSurfaceParameters> InstanceVariationParameters;
+
+	TArray<TPair<TWeakObjectPtr<UDynamicMesh>, FDelegateHandle>> DynamicMeshSubscriptions;
 	
+	/**
+	 * Schedules the parameters to be pushed at the end of the frame.  @see FlushSurfaceParameters
+	 */
+	void MarkParametersDirty();
+
+	void SetParameter_Preset(USimpleSurfacePreset* InPreset);
+	void SetParameter_PresetOverrides(int32 InOverrides);
 	void SetParameter_Color(const FColor& InColor);
 	void SetParameter_Glow(const float& InGlow);
 	void SetParameter_ShininessRoughness(const float& InValue);
 	void SetParameter_WaxinessMetalness(const float& InValue);
-	void SetParameter_Texture(UTexture* InTexture);
+	void SetParameter_Texture(const TSoftObjectPtr<UTexture>& InTexture);
 	void SetParameter_TextureIntensity(const float& InValue);
 	void SetParameter_TextureScale(const float& InValue);
 	void SetParameter_ShowGrid(const float& InValue);
 	void SetParameter_GridSettings(const FSimpleSurfaceGridParams& InParams);
+	void SetParameter_InstanceVariation(const FSimpleSurfaceInstanceVariation& InVariation);
 
 protected:
 	/**
-	 * Initializes the UMaterialInstanceDynamic used by this component, ensuring that the instance has this component as its outer.  Does NOT assign the material to any meshes.
+	 * Initializes the UMaterialInstanceDynamic used by this component.  In a world, this is an instance shared with all other components
+	 * having the same parameters; otherwise it's an instance having this component as its outer.  Does NOT assign the material to any meshes.
 	 */
 	void InitializeSharedMID();
 
-	void ApplyParametersToMaterial() const;
+	USimpleSurfaceSubsystem* GetSurfaceSubsystem() const;
+
+	/**
+	 * Returns true if this surface is currently rendered through custom primitive data.  @see RenderMode
+	 */
+	bool UsesCustomPrimitiveData() const;
+
+	/**
+	 * Returns the material assigned to the actor's mesh slots: the shared custom data material or SimpleSurfaceMaterial.
+	 */
+	UMaterialInterface* GetSurfaceMaterial() const;
+
+	/**
+	 * Returns true if the specified mesh is an instanced mesh that gets per-instance variation.  @see InstanceVariation
+	 */
+	bool UsesInstanceVariation(const UMeshComponent& MeshComponent) const;
+
+	/**
+	 * Returns the material to assign to the specified mesh's slots.
+	 */
+	UMaterialInterface* GetSurfaceMaterialFor(const UMeshComponent& MeshComponent) const;
+
+	/**
+	 * Returns true if the specified material is one SimpleSurface assigns, rather than one to capture.
+	 */
+	bool IsSurfaceMaterial(const UMaterialInterface* Material) const;
+
+	/**
+	 * Writes this component's parameters to the custom primitive data of all meshes of the owning actor.
+	 */
+	void ApplyParametersToCustomData();
+
+	/**
+	 * Resets the custom primitive data written by @see ApplyParametersToCustomData.
+	 */
+	void ClearCustomData();
+
+	/**
+	 * Writes varied parameters to the per-instance custom data of the actor's instanced meshes, in bulk.
+	 */
+	void ApplyInstanceVariation();
+
+	/**
+	 * Removes the per-instance custom data written by @see ApplyInstanceVariation.
+	 */
+	void ClearInstanceVariation();
+
+	/**
+	 * Switches SimpleSurfaceMaterial to the pooled instance matching this component's current parameters.
+	 */
+	void AcquirePooledMaterial(USimpleSurfaceSubsystem& Subsystem);
+
+	/**
+	 * Gives up this component's reference to its pooled instance, if it has one.
+	 */
+	void ReleasePooledMaterial();
+
+	/**
+	 * Pushes any parameters that changed since the last push to the SimpleSurface material.
+	 */
+	void ApplyParametersToMaterial();
 
 	/**
 	 * Applies the SimpleSurface material to all meshes of the owning actor.
 	 */
-	void ApplyMaterialToMeshes() const;
+	void ApplyMaterialToMeshes();
 
-	static TArray<int32> GetIndexPath(USceneComponent& Component);
+	/**
+	 * Assigns the SimpleSurface material to every slot of the specified mesh components.
+	 */
+	void AssignSurfaceMaterial(TConstArrayView<UMeshComponent*> MeshComponents);
 
 	/**
-	 * Updates this component's internal state to capture the actor's current mesh components and their assigned materials,
-	 * so they can be restored later if the component is deleted or deactivated.
-	 *
-	 * This also works across sessions. :)
-	 *
-	 * @see TryRestoreMaterials
-	 * 
-	 * @remarks This function captures two data structures:
-	 *   1. a transient map of mesh component references and their materials, used to reconcile changes to the actor's components while SimpleSurface is active
-	 *   2. a map of mesh component "paths" and their materials, used when duplicating actors and their components  
+	 * Captures and applies SimpleSurface to only the mesh components that changed since it was last applied: those
+	 * whose mesh or slot count changed, or that show a material other than the surface's.
 	 */
-	void UpdateMeshCatalog();
+	void ApplyToChangedMeshes();
 
 	/**
 	 * Attempts to restore captured materials to their original state.
 	 * If components or referenced materials are no longer valid, they are ignored.
+	 *
+	 * Materials that aren't loaded are requested in one asynchronous batch and applied once it completes, unless
+	 * bWaitForLoads is true or a commandlet is running.
 	 */
-	void TryRestoreMaterials();
+	void TryRestoreMaterials(bool bWaitForLoads = false);
 
-	ComponentMaterialMap CreateComponentMaterialMap() const;
-	void UpdateComponentMaterialMap(ComponentMaterialMap &InOutMap) const;
+	/**
+	 * Applies captured materials to every catalogued mesh component that still exists.
+	 */
+	void ApplyCapturedMaterials();
+
+	/**
+	 * Abandons a restore that's waiting for materials to load, e.g. because SimpleSurface is being applied again.
+	 */
+	void CancelMaterialRestore();
 	
+	/**
+	 * The state of the actor's mesh components that change detection compares against, read on the game thread.
+	 */
+	struct FChangeCheckInputs
+	{
+		int32 NumMeshComponents = 0;
+
+		/** The component of each catalog entry, or null if it no longer exists, and its current number of slots. */
+		TArray<UMeshComponent*, TInlineAllocator<8>> CatalogComponents;
+		TArray<int32, TInlineAllocator<8>> CatalogNumSlots;
+
+		/** The material currently shown in each slot of each mesh component, including nulls. */
+		TArray<const UMaterialInterface*, TInlineAllocator<32>> Materials;
+		const UMaterialInterface* CustomDataMaterial = nullptr;
+
+		bool bInstanceCountChanged = false;
+
+		/** True if the identities of all the actor's meshes can be resolved off the game thread.  @see FSimpleSurfaceMeshIdentity::IsThreadSafe */
+		bool bThreadSafe = true;
+	};
+
 	/**
 	 * Compares the current state of mesh components and materials to the last known state and returns true if a change
 	 * occurred that warrants re-applying SimpleSurface.  Does not update any data if changes are found.
 	 */
 	bool MonitorForChanges() const;
-};
\ No newline at end of file
+
+	/**
+	 * Reads the inputs of DetectChanges().  Must run on the game thread.
+	 */
+	void GatherChangeCheckInputs(FChangeCheckInputs& OutInputs) const;
+
+	/**
+	 * Returns true if the gathered inputs differ from the last known state.  Only reads the inputs and the component's
+	 * own records, so it may run off the game thread if the inputs are thread safe.
+	 */
+	bool DetectChanges(const FChangeCheckInputs& Inputs) const;
+
+	/**
+	 * Enables ticking, subsystem monitoring or event subscriptions according to @see ChangeDetection.
+	 */
+	void UpdateChangeDetection();
+
+	/**
+	 * Subscribes to change notifications of the dynamic meshes currently presented by the actor's mesh components.
+	 */
+	void RefreshDynamicMeshSubscriptions();
+	void ClearDynamicMeshSubscriptions();
+	void HandleDynamicMeshChanged(UDynamicMesh* Mesh, FDynamicMeshChangeInfo ChangeInfo);
+
+	/**
+	 * Re-captures materials and re-applies SimpleSurface if a change notification arrived since the last call.  Returns
+	 * true if it re-applied.
+	 */
+	bool ProcessPendingChanges();
+
+	friend class USimpleSurfaceSubsystem;
+	friend struct FSimpleSurfaceComponentInstanceData;
+};
+
+/**
+ * Carries a SimpleSurfaceComponent's mesh catalog across a construction script rerun, which destroys the component
+ * and creates a new one.  The catalog holds the materials captured before SimpleSurface was applied, which the new
+ * component can't capture itself.
+ */
+USTRUCT()
+struct FSimpleSurfaceComponentInstanceData : public FActorComponentInstanceData
+{
+	GENERATED_BODY()
+
+	FSimpleSurfaceComponentInstanceData() = default;
+	explicit FSimpleSurfaceComponentInstanceData(const USimpleSurfaceComponent* SourceComponent);
+
+	virtual bool ContainsData() const override { return true; }
+	virtual void ApplyToComponent(UActorComponent* Component, const ECacheApplyPhase CacheApplyPhase) override;
+
+	UPROPERTY()
+	FSimpleSurfaceMeshCatalog MeshCatalog;
+};
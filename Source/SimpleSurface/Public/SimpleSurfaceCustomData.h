@@ -0,0 +1,88 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UInstancedStaticMeshComponent;
+class UPrimitiveComponent;
+struct FSimpleSurfaceInstanceVariation;
+struct FSimpleSurfaceParameters;
+
+/**
+ * Layout of SimpleSurface parameters in a primitive's custom primitive data, as read by the custom data material.
+ */
+namespace SimpleSurfaceCustomData
+{
+	/** Linear color; occupies three floats. */
+	constexpr int32 Color = 0;
+	constexpr int32 Glow = 3;
+	constexpr int32 ShininessRoughness = 4;
+	constexpr int32 WaxinessMetalness = 5;
+	constexpr int32 TextureIntensity = 6;
+	constexpr int32 TextureScale = 7;
+	constexpr int32 ShowGrid = 8;
+	constexpr int32 GridSize = 9;
+	constexpr int32 SubGridDivisions = 10;
+	constexpr int32 ObjectAligned = 11;
+
+	/** The number of floats used. */
+	constexpr int32 Num = 12;
+
+	using FPackedParameters = TArray<float, TInlineAllocator<Num>>;
+
+	/**
+	 * Packs the specified parameters in the layout above.  The texture override isn't representable and is ignored.
+	 */
+	SIMPLESURFACE_API FPackedParameters Pack(const FSimpleSurfaceParameters& Parameters);
+
+	/**
+	 * Writes packed parameters to the component's custom primitive data, skipping the write if nothing changed.
+	 */
+	SIMPLESURFACE_API void Write(UPrimitiveComponent& Component, const FPackedParameters& Packed);
+
+	/**
+	 * Resets the floats used by SimpleSurface to the component's default custom primitive data.
+	 */
+	SIMPLESURFACE_API void Clear(UPrimitiveComponent& Component);
+
+	/**
+	 * Writes every instance's varied parameters to the component's per-instance custom data, in the layout above.
+	 * The data is replaced in one assignment, and the render state dirtied once, only if any of it changed.
+	 *
+	 * @return The number of instances written.
+	 */
+	SIMPLESURFACE_API int32 WriteInstances(UInstancedStaticMeshComponent& Component, const FSimpleSurfaceParameters& Base, const FSimpleSurfaceInstanceVariation& Variation);
+
+	/**
+	 * An instanced mesh's own per-instance custom data, from before @see WriteInstances took it over.
+	 */
+	struct FInstanceData
+	{
+		int32 NumFloats = 0;
+		TArray<float> Data;
+	};
+
+	/**
+	 * Captures the component's per-instance custom data.  Call before the first write.  A component already having
+	 * SimpleSurface's floats, e.g. saved while varied, is assumed to have had as many as its archetype, all zero.
+	 */
+	SIMPLESURFACE_API FInstanceData CaptureInstances(const UInstancedStaticMeshComponent& Component);
+
+	/**
+	 * Removes the per-instance custom data written by @see WriteInstances, restoring the data captured before.
+	 * Instances added since are zeroed.
+	 */
+	SIMPLESURFACE_API void ClearInstances(UInstancedStaticMeshComponent& Component, const FInstanceData& DataBeforeWrite);
+}
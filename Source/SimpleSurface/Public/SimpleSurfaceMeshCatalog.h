@@ -0,0 +1,201 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "SimpleSurfaceMeshCatalog.generated.h"
+
+class AActor;
+class UMaterialInterface;
+class UMeshComponent;
+class USceneComponent;
+
+/**
+ * One mesh component captured by a @see FSimpleSurfaceMeshCatalog.  Its materials and index path are ranges into the
+ * catalog's shared arrays.
+ */
+USTRUCT()
+struct FSimpleSurfaceMeshCatalogEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSoftObjectPtr<UMeshComponent> Component;
+
+	/**
+	 * A hash of the mesh presented by Component.  Used to determine if an existing component's mesh changed.
+	 */
+	UPROPERTY()
+	uint32 MeshHash = -1;
+
+	/**
+	 * The range of this entry's materials in the catalog's Materials, indexed by slot.
+	 */
+	UPROPERTY()
+	int32 FirstSlot = 0;
+
+	UPROPERTY()
+	int32 NumSlots = 0;
+
+	/**
+	 * The range of this entry's path from the actor's root component in the catalog's IndexPaths.
+	 */
+	UPROPERTY()
+	int32 FirstPathIndex = 0;
+
+	UPROPERTY()
+	int32 PathLength = 0;
+
+	/**
+	 * False for entries loaded from disk until they're first captured again.
+	 */
+	bool bCapturedThisSession = false;
+};
+
+/**
+ * Captures the meshes and materials of an actor's mesh components for later restoration, e.g. if SimpleSurfaceComponent is removed.
+ *
+ * Storage is flat: every component's materials live in one shared array, addressed by slot ranges, so capturing and
+ * scanning an actor's components touches a handful of contiguous allocations rather than one per component.
+ *
+ * Packages store the catalog compactly: each material path once, slots as packed indexes into those paths, and the
+ * excluded classes only if they aren't the default.  Catalogs saved before are loaded from their tagged properties.
+ */
+USTRUCT()
+struct SIMPLESURFACE_API FSimpleSurfaceMeshCatalog
+{
+	GENERATED_BODY()
+
+	FSimpleSurfaceMeshCatalog();
+
+	UPROPERTY()
+	TArray<FSimpleSurfaceMeshCatalogEntry> Entries;
+
+	UPROPERTY()
+	TArray<TSoftObjectPtr<UMaterialInterface>> Materials;
+
+	UPROPERTY()
+	TArray<int32> IndexPaths;
+
+	/**
+	 * Materials of these classes are never captured.
+	 */
+	UPROPERTY()
+	TArray<TSoftClassPtr<UMaterialInterface>> ExcludedMaterialClasses;
+
+	/**
+	 * Updates the catalog to reflect the specified mesh components.  ExcludedMaterials are never captured, in addition to
+	 * ExcludedMaterialClasses.  Entries for other components are kept for as long as those components exist.
+	 */
+	void Capture(TConstArrayView<UMeshComponent*> MeshComponents, TConstArrayView<const UMaterialInterface*> ExcludedMaterials = {});
+
+	/**
+	 * Adds an entry from data captured elsewhere, e.g. by an older version of the plugin.
+	 */
+	void AddEntry(const TSoftObjectPtr<UMeshComponent>& Component, uint32 MeshHash, TConstArrayView<TSoftObjectPtr<UMaterialInterface>> EntryMaterials, TConstArrayView<int32> IndexPath);
+
+	/**
+	 * Adds Other's entries for components this catalog has no entry for.
+	 */
+	void Merge(const FSimpleSurfaceMeshCatalog& Other);
+
+	/**
+	 * Adds the specified mesh components that weren't captured this session, or that present a different mesh or number
+	 * of material slots than when they were, to OutChanged.
+	 */
+	void GetChangedComponents(TConstArrayView<UMeshComponent*> MeshComponents, TArray<UMeshComponent*, TInlineAllocator<32>>& OutChanged) const;
+
+	/**
+	 * Points entries captured from another actor, e.g. the one this actor was duplicated or pasted from, at the
+	 * corresponding mesh components of the specified actor.  Components are matched by name, which reordering siblings
+	 * doesn't change, and failing that by index path.  Each component is matched once; entries without a match are removed.
+	 *
+	 * @return True if any entry was remapped or removed.
+	 */
+	bool RemapToActor(const AActor& Actor);
+
+	/**
+	 * Drops entries whose component no longer exists.
+	 */
+	void RemoveStaleEntries();
+
+	/**
+	 * Drops the entries for which Predicate returns true.
+	 */
+	void RemoveEntries(TFunctionRef<bool(const FSimpleSurfaceMeshCatalogEntry&)> Predicate);
+
+	TConstArrayView<TSoftObjectPtr<UMaterialInterface>> GetMaterials(const FSimpleSurfaceMeshCatalogEntry& Entry) const;
+	TConstArrayView<int32> GetIndexPath(const FSimpleSurfaceMeshCatalogEntry& Entry) const;
+
+	/**
+	 * Applies the materials captured for the specified entry to its component.  Slots whose material isn't loaded, and
+	 * slots the component gained since, are left to the mesh's own materials; @see CollectUnloadedMaterials.
+	 */
+	void ApplyMaterials(const FSimpleSurfaceMeshCatalogEntry& Entry, UMeshComponent& MeshComponent) const;
+
+	/**
+	 * Assigns materials to a mesh component's slots in one pass, writing only the slots whose material differs.  A null
+	 * material clears the slot's override.  The component is modified, for undo, at most once, and only if a slot changes.
+	 *
+	 * @return The number of slots written.
+	 */
+	static int32 AssignMaterials(UMeshComponent& MeshComponent, TConstArrayView<UMaterialInterface*> Materials, bool bAlwaysMarkDirty = true);
+
+	/**
+	 * Adds the paths of captured materials that aren't currently loaded to OutPaths.
+	 */
+	void CollectUnloadedMaterials(TArray<FSoftObjectPath>& OutPaths) const;
+
+	/**
+	 * Returns true if any captured component no longer exists, or presents a different mesh or number of material slots
+	 * than when it was captured.  @see FSimpleSurfaceMeshIdentity
+	 */
+	bool HasMeshChanged() const;
+
+	/**
+	 * As above, given each entry's component resolved beforehand, or null if it no longer exists, and its current
+	 * number of slots.  May run off the game thread if the components' mesh identities can be resolved there.
+	 */
+	bool HasMeshChanged(TConstArrayView<UMeshComponent*> EntryComponents, TConstArrayView<int32> EntryNumSlots) const;
+
+	bool IsEmpty() const { return Entries.IsEmpty(); }
+
+	SIZE_T GetAllocatedSize() const;
+
+	bool Serialize(FArchive& Ar);
+
+	/**
+	 * Returns approximately how many bytes the catalog takes up in a package: compactly, or as tagged properties like
+	 * catalogs saved by older versions.
+	 */
+	int64 GetSavedSize(bool bCompact = true) const;
+
+	static uint32 GetMeshHash(UMeshComponent* MeshComponent);
+
+	/**
+	 * Returns an array of indexes that represent the path to the component from the root component.
+	 */
+	static TArray<int32, TInlineAllocator<8>> GetIndexPath(const USceneComponent& Component);
+};
+
+template<>
+struct TStructOpsTypeTraits<FSimpleSurfaceMeshCatalog> : public TStructOpsTypeTraitsBase2<FSimpleSurfaceMeshCatalog>
+{
+	enum
+	{
+		WithSerializer = true,
+	};
+};
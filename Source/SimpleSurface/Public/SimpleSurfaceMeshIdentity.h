@@ -0,0 +1,102 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UDynamicMesh;
+class UMeshComponent;
+
+/**
+ * Identifies the mesh a mesh component presents, so SimpleSurface can tell when it changed.
+ *
+ * Identity is resolved by a provider registered for the component's class or its nearest registered superclass.
+ * Built-in providers cover static meshes (including instanced and spline meshes), skinned meshes and dynamic meshes;
+ * projects can register providers for their own component types, e.g. from their module's StartupModule:
+ *
+ *     FSimpleSurfaceMeshIdentity::Get().RegisterProvider(UMyMeshComponent::StaticClass(), [](const UMeshComponent& Component)
+ *     {
+ *         return GetTypeHash(CastChecked<UMyMeshComponent>(&Component)->GetMyMesh());
+ *     });
+ *
+ * Components without a provider are identified by their number of material slots.
+ *
+ * Providers that only read the component and its mesh asset can be registered as thread-safe, letting the subsystem
+ * check the components they cover for changes in parallel.
+ */
+class SIMPLESURFACE_API FSimpleSurfaceMeshIdentity
+{
+public:
+	using FProvider = TFunction<uint32(const UMeshComponent&)>;
+
+	static FSimpleSurfaceMeshIdentity& Get();
+
+	/**
+	 * Registers a provider for the specified component class and its subclasses, replacing any registered before.
+	 */
+	void RegisterProvider(const UClass* ComponentClass, FProvider Provider, bool bIsThreadSafe = false);
+	void UnregisterProvider(const UClass* ComponentClass);
+
+	/**
+	 * Returns a hash identifying the mesh presented by the specified component.
+	 */
+	uint32 GetMeshIdentity(const UMeshComponent& Component) const;
+
+	/**
+	 * Returns true if the identity of the mesh presented by the specified component can be resolved off the game thread.
+	 */
+	bool IsThreadSafe(const UMeshComponent& Component) const;
+
+	/**
+	 * Returns a number that changes every time the specified dynamic mesh is edited.
+	 */
+	uint32 GetChangeStamp(UDynamicMesh& DynamicMesh);
+
+	/**
+	 * Registers the providers for engine component types.
+	 */
+	void RegisterBuiltInProviders();
+
+	/**
+	 * Drops all providers and stops tracking dynamic mesh edits.
+	 */
+	void Reset();
+
+private:
+	/**
+	 * Returns the provider registered for the class or its nearest registered superclass, if any.
+	 */
+	struct FRegisteredProvider
+	{
+		FProvider Provider;
+		bool bIsThreadSafe = false;
+	};
+
+	const FRegisteredProvider* FindProvider(const UClass* ComponentClass) const;
+
+	TMap<const UClass*, FRegisteredProvider> Providers;
+
+	/** Resolved providers by component class, including classes without a provider; cleared whenever providers change. */
+	mutable TMap<const UClass*, const FRegisteredProvider*> ResolvedProviders;
+	mutable FRWLock ResolvedProvidersLock;
+
+	struct FTrackedDynamicMesh
+	{
+		uint32 ChangeStamp = 0;
+		FDelegateHandle ChangedHandle;
+	};
+
+	TMap<TObjectKey<UDynamicMesh>, FTrackedDynamicMesh> TrackedDynamicMeshes;
+};
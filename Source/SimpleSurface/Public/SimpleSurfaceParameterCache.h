@@ -0,0 +1,70 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SimpleSurfaceTypes.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UMaterialInstanceDynamic;
+
+/**
+ * Pushes SimpleSurface parameters to a UMaterialInstanceDynamic, skipping any parameter whose value hasn't changed
+ * since the last push.
+ *
+ * The first push to a material instance initializes every parameter and remembers its index in the instance's
+ * parameter arrays, so later pushes neither look parameters up by name nor touch unchanged values.
+ */
+class SIMPLESURFACE_API FSimpleSurfaceParameterCache
+{
+public:
+	/**
+	 * Pushes the parameters that differ from the last push to the specified material.  Pushing to a different material
+	 * than last time pushes everything.
+	 *
+	 * @return The number of parameters pushed.
+	 */
+	int32 Apply(UMaterialInstanceDynamic& Material, const FSimpleSurfaceParameters& Parameters);
+
+	/**
+	 * Forgets the last pushed values, so the next push pushes everything.
+	 */
+	void Reset();
+
+	/**
+	 * The number of parameters pushed by a full push.
+	 */
+	static constexpr int32 NumParameters = 14;
+
+private:
+	void Initialize(UMaterialInstanceDynamic& Material, const FSimpleSurfaceParameters& Parameters);
+
+	TWeakObjectPtr<UMaterialInstanceDynamic> CachedMaterial;
+
+	FSimpleSurfaceParameters PushedParameters;
+
+	int32 ColorIndex = INDEX_NONE;
+	int32 GlowIndex = INDEX_NONE;
+	int32 WaxinessMetalnessIndex = INDEX_NONE;
+	int32 ShininessRoughnessIndex = INDEX_NONE;
+	int32 TextureIntensityIndex = INDEX_NONE;
+	int32 TextureScaleIndex = INDEX_NONE;
+	int32 ShowGridIndex = INDEX_NONE;
+	int32 GridSizeIndex = INDEX_NONE;
+	int32 SubGridNumberIndex = INDEX_NONE;
+	int32 ObjectAlignedIndex = INDEX_NONE;
+	int32 AnimationModeIndex = INDEX_NONE;
+	int32 AnimationTargetIndex = INDEX_NONE;
+	int32 AnimationTimingIndex = INDEX_NONE;
+};
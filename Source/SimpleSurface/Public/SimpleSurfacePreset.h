@@ -0,0 +1,116 @@
+﻿// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SimpleSurfaceParameterCache.h"
+#include "SimpleSurfaceTypes.h"
+
+#include "SimpleSurfacePreset.generated.h"
+
+class UMaterialInstanceDynamic;
+class UMaterialInterface;
+
+/**
+ * A surface shared by many SimpleSurfaceComponents.  Components using a preset without overriding any of its values all
+ * render through one material instance owned by the preset, so editing the preset updates every one of them at once.
+ */
+UCLASS(BlueprintType)
+class SIMPLESURFACE_API USimpleSurfacePreset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(DisplayName = "🖌️ Color", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly, meta = (HideAlphaChannel))
+	FColor Color = FColor::FromHex("D84DC2");
+
+	UPROPERTY(DisplayName = "☀️ Glow", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = 0.0f, ClampMax = 10.0f))
+	float Glow = 0.0f;
+
+	UPROPERTY(DisplayName = "💎 Shininess / Roughness 🍞", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = 0.0f, ClampMax = 1.0f))
+	float ShininessRoughness = 0.5f;
+
+	UPROPERTY(DisplayName = "🕯️ Waxiness / Metalness 🔩", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = 0.0f, ClampMax = 1.0f))
+	float WaxinessMetalness = 0.5f;
+
+	UPROPERTY(DisplayName = "🧱 Texture Intensity", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = 0.0f, ClampMax = 1.0f))
+	float TextureIntensity = 0.1f;
+
+	UPROPERTY(DisplayName = "🧱 Texture Scale", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = 0.0f, ClampMax = 1.0f))
+	float TextureScale = 1.0f;
+
+	/**
+	 * An optional texture to use as a normal map instead of the built-in texture.  It's streamed in by the surfaces using
+	 * the preset.
+	 */
+	UPROPERTY(DisplayName = "🧱 Texture Override", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly)
+	TSoftObjectPtr<UTexture> Texture;
+
+	UPROPERTY(DisplayName = "📐 Grid Intensity", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = -1.0f, ClampMax = 1.0f))
+	float ShowGrid = 0.0f;
+
+	UPROPERTY(DisplayName = "📐 Grid Tweaks", Category = "🎨 Simple Surface", EditAnywhere, BlueprintReadOnly)
+	FSimpleSurfaceGridParams GridParams;
+
+	/**
+	 * Returns the preset's values as material parameters.
+	 */
+	FSimpleSurfaceParameters GetParameters() const;
+
+	/**
+	 * Returns the instance of Parent shared by the surfaces using this preset unchanged, creating it if needed.  Asking for
+	 * a different parent than last time, e.g. because the preset's features changed, replaces the instance.
+	 */
+	UMaterialInstanceDynamic* GetMaterial(UMaterialInterface* Parent);
+
+	/**
+	 * Returns true if the specified material is this preset's shared instance.
+	 */
+	bool IsPresetMaterial(const UMaterialInterface* InMaterial) const { return InMaterial && InMaterial == Material; }
+
+	/**
+	 * Pushes the preset's values to its shared instance and tells the surfaces using the preset.  Call this after changing
+	 * the preset's values outside the editor.
+	 */
+	void NotifyChanged();
+
+	/**
+	 * Raised when the preset's values change.  The parameter is true if the preset's features changed, so surfaces
+	 * rendering through the shared instance may need an instance of another permutation.
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnPresetChanged, bool /*bFeaturesChanged*/);
+	FOnPresetChanged& OnPresetChanged() { return PresetChangedEvent; }
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<UMaterialInstanceDynamic> Material;
+
+	/**
+	 * Remembers what was last pushed to Material, so unchanged parameters aren't pushed again.
+	 */
+	FSimpleSurfaceParameterCache ParameterCache;
+
+	/**
+	 * The features of the preset when Material was created.
+	 */
+	ESimpleSurfaceFeatures MaterialFeatures = ESimpleSurfaceFeatures::None;
+
+	FOnPresetChanged PresetChangedEvent;
+};
@@ -0,0 +1,185 @@
+﻿// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SimpleSurfaceMeshCatalog.h"
+#include "SimpleSurfaceTypes.h"
+#include "UObject/ObjectKey.h"
+
+#include "SimpleSurfaceRules.generated.h"
+
+class UDataLayerAsset;
+class ULevel;
+class UMaterialInstance;
+class UMaterialInterface;
+class UMeshComponent;
+class USimpleSurfacePreset;
+
+/**
+ * Gives every actor matching its criteria a surface.  Criteria left empty match every actor.
+ */
+USTRUCT(BlueprintType)
+struct SIMPLESURFACE_API FSimpleSurfaceRule
+{
+	GENERATED_BODY()
+
+	/**
+	 * Only actors of this class or its subclasses match.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Match")
+	TSubclassOf<AActor> ActorClass;
+
+	/**
+	 * Only actors with this tag match.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Match")
+	FName Tag;
+
+	/**
+	 * Only actors in this outliner folder or its subfolders match.  Folders only exist in the editor, so rules with a
+	 * folder match nothing in packaged games.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Match")
+	FName Folder;
+
+	/**
+	 * Only actors in this data layer match.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Match")
+	TObjectPtr<UDataLayerAsset> DataLayer;
+
+	/**
+	 * Only actors whose label (or name, outside the editor) matches this wildcard pattern match, e.g. "Blockout_*".
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Match")
+	FString NamePattern;
+
+	/**
+	 * The surface matching actors get.  Every actor using a preset shares the preset's material instance.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface")
+	TObjectPtr<USimpleSurfacePreset> Preset;
+
+	/**
+	 * The surface matching actors get when there's no preset.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface", meta = (EditCondition = "Preset == nullptr"))
+	FSimpleSurfaceParameters Parameters;
+
+	/**
+	 * Returns true if the specified actor meets every criterion.
+	 */
+	bool Matches(const AActor& Actor) const;
+};
+
+/**
+ * Applies SimpleSurface to the actors in its world by rule, without a SimpleSurfaceComponent on each of them.  Matching
+ * actors share one material instance per rule, and their original materials are kept in one catalog for the whole
+ * world, so the cost of a rule set doesn't grow with the number of actors it applies to beyond that catalog.
+ *
+ * The first rule an actor matches wins.  Actors with a SimpleSurfaceComponent are left to their component.  Rules are
+ * re-applied when they're edited, when levels are added to the world and to actors as they're spawned; changes to an
+ * existing actor's tags, folder or label are picked up by @see ReapplyRules.
+ */
+UCLASS(NotBlueprintable, HideCategories = (Actor, Advanced, Collision, Cooking, Input, LOD, Physics, Rendering, Replication))
+class SIMPLESURFACE_API ASimpleSurfaceRules : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASimpleSurfaceRules();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "🎨 Simple Surface")
+	TArray<FSimpleSurfaceRule> Rules;
+
+	/**
+	 * Re-applies the rules to every actor in the world at the end of the frame.  Call this after changing the rules, or
+	 * existing actors' tags, folders or labels, at runtime.
+	 */
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "🎨 Simple Surface")
+	void ReapplyRules();
+
+	/**
+	 * Applies any re-application or newly spawned actors waiting since @see ReapplyRules now.
+	 */
+	void FlushPendingRules();
+
+	/**
+	 * Returns the number of actors currently given a surface by these rules.
+	 */
+	int32 GetNumAppliedActors() const { return AppliedRules.Num(); }
+
+	virtual void PostRegisterAllComponents() override;
+	virtual void PostUnregisterAllComponents() override;
+	virtual void Destroyed() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+#endif
+
+private:
+	UPROPERTY()
+	TObjectPtr<UMaterialInstance> BaseMaterial;
+
+	/**
+	 * The original materials of every mesh component these rules changed.
+	 */
+	UPROPERTY()
+	FSimpleSurfaceMeshCatalog MeshCatalog;
+
+	/**
+	 * The material each rule applies, by rule index.  Rules with a preset use the preset's instance.
+	 */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMaterialInterface>> RuleMaterials;
+
+	/**
+	 * The rule applied to each actor, by actor.
+	 */
+	TMap<TObjectKey<AActor>, int32> AppliedRules;
+
+	TArray<TWeakObjectPtr<AActor>> PendingActors;
+	bool bRulesDirty = false;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+	TArray<TPair<TWeakObjectPtr<USimpleSurfacePreset>, FDelegateHandle>> PresetSubscriptions;
+
+	/**
+	 * Schedules pending work for the end of the frame.
+	 */
+	void QueueUpdate();
+
+	void ApplyRules();
+	void ApplyToActors(TConstArrayView<AActor*> Actors);
+	void RestoreAll();
+
+	/**
+	 * Creates or updates each rule's material instance.
+	 */
+	void UpdateRuleMaterials();
+
+	/**
+	 * Returns the index of the first rule the specified actor matches, or INDEX_NONE.
+	 */
+	int32 FindRule(const AActor& Actor) const;
+
+	void OnActorSpawned(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnPresetChanged(bool bFeaturesChanged);
+};
@@ -0,0 +1,330 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SimpleSurfaceMeshCatalog.h"
+#include "SimpleSurfaceTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "SimpleSurfaceSubsystem.generated.h"
+
+class AActor;
+class UMaterialInstanceDynamic;
+class UMaterialInterface;
+class ASimpleSurfaceRules;
+class USimpleSurfaceComponent;
+struct FStreamableHandle;
+
+/**
+ * Identifies a pooled SimpleSurface material: the material it's an instance of, and the parameters pushed to it.
+ */
+USTRUCT()
+struct FSimpleSurfaceMaterialKey
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UMaterialInterface> Parent;
+
+	UPROPERTY()
+	FSimpleSurfaceParameters Parameters;
+
+	bool operator==(const FSimpleSurfaceMaterialKey& Other) const = default;
+
+	friend uint32 GetTypeHash(const FSimpleSurfaceMaterialKey& Key)
+	{
+		return HashCombineFast(GetTypeHash(Key.Parent), GetTypeHash(Key.Parameters));
+	}
+};
+
+USTRUCT()
+struct FSimpleSurfacePooledMaterial
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UMaterialInstanceDynamic> Material;
+
+	/**
+	 * The number of SimpleSurfaceComponents currently using Material.
+	 */
+	int32 RefCount = 0;
+};
+
+/**
+ * Counters describing the subsystem's most recent frame of change detection.
+ */
+struct FSimpleSurfaceMonitorStats
+{
+	/** The number of polling components registered for monitoring. */
+	int32 NumMonitored = 0;
+
+	/** The number of components checked for changes. */
+	int32 NumChecked = 0;
+
+	/** The number of components that changed and had SimpleSurface re-applied, including event-driven ones. */
+	int32 NumReapplied = 0;
+
+	/** Time spent checking and re-applying, in milliseconds. */
+	double ElapsedMilliseconds = 0.0;
+};
+
+/**
+ * Shared, per-world state for SimpleSurfaceComponents.
+ *
+ * Hands out reference-counted material instances, so that components with identical parameters share one
+ * UMaterialInstanceDynamic rather than each creating their own.
+ *
+ * Streams in texture overrides on surfaces' behalf, keeping each loaded only while some surface uses it.
+ *
+ * Swaps distant surfaces to a flat-color permutation of the SimpleSurface material, evaluating a slice of the surfaces
+ * each frame against the locations the world was last rendered from.
+ *
+ * Also runs change detection for every component in one batched loop, instead of each component ticking.  Polling
+ * components are checked round-robin within a per-frame time budget, and components that haven't changed in a while
+ * are checked less and less often.  Event-driven components that received a notification are processed here too.
+ */
+UCLASS(Config = Game)
+class SIMPLESURFACE_API USimpleSurfaceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * The material shared by all surfaces rendered with custom primitive data.  It must read its parameters from custom
+	 * primitive data in the layout described by @see SimpleSurfaceCustomData.
+	 */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UMaterialInterface> CustomDataMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/SimpleSurface/Materials/MI_SimpleSurface_CustomData.MI_SimpleSurface_CustomData")));
+
+	/**
+	 * Returns the loaded @see CustomDataMaterial, or null if it isn't available.
+	 */
+	static UMaterialInterface* GetCustomDataMaterial();
+
+	/**
+	 * Where pre-authored permutations of the SimpleSurface material live.  Each is a material instance whose static
+	 * switches disable the features its name says are off, e.g. MI_SimpleSurface_NoGrid_NoGlow.
+	 * @see GetPermutationMaterial
+	 */
+	UPROPERTY(Config)
+	FString PermutationMaterialPath = TEXT("/SimpleSurface/Materials/Permutations");
+
+	/**
+	 * Returns the pre-authored permutation of the SimpleSurface material with exactly the specified features, or null
+	 * if there isn't one and the default material should be used.  Permutations are never created at runtime, so
+	 * switching between them never compiles shaders.
+	 */
+	static UMaterialInterface* GetPermutationMaterial(ESimpleSurfaceFeatures Features);
+
+	/**
+	 * Returns the asset name of the permutation with the specified features.
+	 */
+	static FString GetPermutationName(ESimpleSurfaceFeatures Features);
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickableInEditor() const override { return true; }
+
+	/**
+	 * Returns a material instance of Parent with the specified parameters, creating it if no component is using one yet.
+	 * Every call must be balanced by a call to @see ReleaseMaterial.
+	 */
+	UMaterialInstanceDynamic* AcquireMaterial(UMaterialInterface* Parent, const FSimpleSurfaceParameters& Parameters);
+
+	/**
+	 * Gives up one reference to a material returned by @see AcquireMaterial.  Instances no longer in use are dropped from
+	 * the pool at the end of the frame, so a component that releases and re-acquires within a frame (e.g. when its actor's
+	 * construction script reruns) gets the same instance back.
+	 */
+	void ReleaseMaterial(UMaterialInstanceDynamic* Material);
+
+	/**
+	 * Returns true if the specified material was handed out by this pool.
+	 */
+	bool IsPooledMaterial(const UMaterialInterface* Material) const;
+
+	/**
+	 * Returns true if the specified pooled material is an instance of Parent with the specified parameters.
+	 */
+	bool PooledMaterialMatches(const UMaterialInterface* Material, const UMaterialInterface* Parent, const FSimpleSurfaceParameters& Parameters) const;
+
+	int32 GetNumPooledMaterials() const { return MaterialPool.Num(); }
+
+	/**
+	 * Starts streaming in the specified texture for a component, whose parameters are pushed again once it loads.  Until
+	 * then, the material shows its built-in texture.  Every call must be balanced by a call to @see ReleaseTexture.
+	 */
+	void RequestTexture(const TSoftObjectPtr<UTexture>& Texture, USimpleSurfaceComponent& Component);
+
+	/**
+	 * Gives up one component's use of a texture passed to @see RequestTexture.  Textures no component uses are no longer
+	 * kept loaded, and loads still in progress are canceled.
+	 */
+	void ReleaseTexture(const TSoftObjectPtr<UTexture>& Texture);
+
+	int32 GetNumRequestedTextures() const { return TextureRequests.Num(); }
+
+	/**
+	 * Returns true if polling components in this world should be monitored here rather than ticking.
+	 */
+	static bool IsCentralMonitoringEnabled();
+
+	/**
+	 * Starts or stops checking the specified polling component for changes.
+	 */
+	void StartMonitoring(USimpleSurfaceComponent& Component);
+	void StopMonitoring(USimpleSurfaceComponent& Component);
+
+	/**
+	 * Starts or stops evaluating the specified component's distance from the viewer.  @see USimpleSurfaceComponent::bUseDistanceLOD
+	 */
+	void StartDistanceLOD(USimpleSurfaceComponent& Component);
+	void StopDistanceLOD(USimpleSurfaceComponent& Component);
+
+	int32 GetNumDistantSurfaces() const { return NumDistantSurfaces; }
+
+	/**
+	 * Queues an event-driven component that received a change notification, to be processed at the end of the frame.
+	 */
+	void QueueChangedComponent(USimpleSurfaceComponent& Component);
+
+	/**
+	 * Queues a component whose parameters were set, to be pushed to its material along with every other such
+	 * component's at the end of the frame.
+	 */
+	void QueueParameterFlush(USimpleSurfaceComponent& Component);
+
+	/**
+	 * Pushes the parameters of every queued component now.
+	 */
+	void FlushSurfaceParameters();
+
+	/**
+	 * Queues a rule set with rules to re-apply or newly spawned actors to apply them to, to be processed at the end of
+	 * the frame.
+	 */
+	void QueueRulesUpdate(ASimpleSurfaceRules& Rules);
+
+	/**
+	 * Queues the catalog of a SimpleSurfaceComponent destroyed in favor of a replacement, e.g. by a construction script
+	 * rerun.  At the end of the frame, its materials are restored if the owner was left without a SimpleSurfaceComponent.
+	 */
+	void QueueOrphanedCatalog(AActor& Owner, const FSimpleSurfaceMeshCatalog& Catalog);
+
+	const FSimpleSurfaceMonitorStats& GetLastFrameStats() const { return LastFrameStats; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY(Transient)
+	TMap<FSimpleSurfaceMaterialKey, FSimpleSurfacePooledMaterial> MaterialPool;
+
+	TMap<TObjectKey<UMaterialInterface>, FSimpleSurfaceMaterialKey> KeysByMaterial;
+
+	bool bPurgePending = false;
+
+	struct FTextureRequest
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+
+		/** The number of components using the texture. */
+		int32 RefCount = 0;
+
+		/** Components to push parameters for when the load completes. */
+		TArray<TWeakObjectPtr<USimpleSurfaceComponent>> WaitingComponents;
+	};
+
+	TMap<FSoftObjectPath, FTextureRequest> TextureRequests;
+
+	/**
+	 * Pushes parameters for the components waiting on a texture that finished loading.
+	 */
+	void OnTextureLoaded(FSoftObjectPath TexturePath);
+
+	/**
+	 * Drops pooled materials that no component is using.
+	 */
+	void PurgeUnusedMaterials();
+
+	struct FMonitoredSurface
+	{
+		TWeakObjectPtr<USimpleSurfaceComponent> Component;
+		TObjectKey<USimpleSurfaceComponent> Key;
+
+		/** The number of consecutive checks that found no change. */
+		int32 IdleChecks = 0;
+
+		/** The frame on which the component is next due to be checked. */
+		uint64 NextCheckFrame = 0;
+	};
+
+	TArray<FMonitoredSurface> MonitoredSurfaces;
+	TMap<TObjectKey<USimpleSurfaceComponent>, int32> MonitoredSurfaceIndexes;
+
+	/** Where the next frame's round-robin pass starts. */
+	int32 MonitorCursor = 0;
+
+	/**
+	 * Checks up to MaxChecks of the components that are due on the specified frame for changes, in the order the
+	 * round-robin pass visits them, unless too few are due to be worth it.  Their inputs are gathered on the game thread
+	 * and compared in parallel.  Components that must be checked on the game thread are left out of OutDetectedChanges.
+	 */
+	void DetectParallelChanges(uint64 Frame, int32 MaxChecks, TMap<TObjectKey<USimpleSurfaceComponent>, bool>& OutDetectedChanges) const;
+
+	struct FLODSurface
+	{
+		TWeakObjectPtr<USimpleSurfaceComponent> Component;
+		TObjectKey<USimpleSurfaceComponent> Key;
+	};
+
+	TArray<FLODSurface> LODSurfaces;
+	TMap<TObjectKey<USimpleSurfaceComponent>, int32> LODSurfaceIndexes;
+
+	/** Where the next frame's slice of distance evaluation starts. */
+	int32 LODCursor = 0;
+
+	int32 NumDistantSurfaces = 0;
+
+	/**
+	 * Evaluates the distance of the next slice of surfaces, switching those that crossed the LOD distance.
+	 */
+	void UpdateDistanceLOD();
+
+	TArray<TWeakObjectPtr<USimpleSurfaceComponent>> ChangedComponents;
+	TArray<TWeakObjectPtr<USimpleSurfaceComponent>> DirtyParameterComponents;
+	TArray<TWeakObjectPtr<ASimpleSurfaceRules>> PendingRuleSets;
+	TArray<TPair<TWeakObjectPtr<AActor>, FSimpleSurfaceMeshCatalog>> OrphanedCatalogs;
+
+	/**
+	 * Restores the materials of queued catalogs whose owner has no SimpleSurfaceComponent anymore.
+	 */
+	void FlushOrphanedCatalogs();
+
+	/**
+	 * Applies the rules of every queued rule set.
+	 */
+	void FlushRules();
+
+	FSimpleSurfaceMonitorStats LastFrameStats;
+
+	/**
+	 * Processes queued event-driven components, then checks as many polling components as the frame's budget allows.
+	 */
+	void MonitorComponents();
+};
@@ -0,0 +1,300 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Texture.h"
+
+#include "SimpleSurfaceTypes.generated.h"
+
+/**
+ * Names of the parameters exposed by the SimpleSurface material.
+ */
+namespace SimpleSurfaceParameterNames
+{
+	extern SIMPLESURFACE_API const FName Color;
+	extern SIMPLESURFACE_API const FName Glow;
+	extern SIMPLESURFACE_API const FName WaxinessMetalness;
+	extern SIMPLESURFACE_API const FName ShininessRoughness;
+	extern SIMPLESURFACE_API const FName Texture;
+	extern SIMPLESURFACE_API const FName TextureIntensity;
+	extern SIMPLESURFACE_API const FName TextureScale;
+	extern SIMPLESURFACE_API const FName ShowGrid;
+	extern SIMPLESURFACE_API const FName GridSize;
+	extern SIMPLESURFACE_API const FName SubGridNumber;
+	extern SIMPLESURFACE_API const FName ObjectAligned;
+	extern SIMPLESURFACE_API const FName AnimationMode;
+	extern SIMPLESURFACE_API const FName AnimationTarget;
+	extern SIMPLESURFACE_API const FName AnimationTiming;
+}
+
+USTRUCT(BlueprintType)
+struct FSimpleSurfaceGridParams
+{
+	GENERATED_BODY()
+
+	FSimpleSurfaceGridParams() = default;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=-0.1f, ClampMax=1000000.0f, UIMin=10.0f, UIMax=1000.0f))
+	float GridSize = 100.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=1.0f, ClampMax=100.0f, UIMin=1.0f, UIMax=100.0f))
+	float SubGridDivisions = 5.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bIsObjectAligned = false;
+
+	bool operator==(const FSimpleSurfaceGridParams& Other) const = default;
+
+	friend SIMPLESURFACE_API uint32 GetTypeHash(const FSimpleSurfaceGridParams& Params);
+};
+
+/**
+ * How an animated surface moves between its own color and glow and the animation's.
+ */
+UENUM(BlueprintType)
+enum class ESimpleSurfaceAnimationMode : uint8
+{
+	/** The surface isn't animated. */
+	None,
+
+	/** Repeatedly blends to the target and back, once per duration. */
+	Pulse,
+
+	/** Blends to the target once, over the duration, and holds it. */
+	Blend
+};
+
+/**
+ * The curve an animation follows over each blend.
+ */
+UENUM(BlueprintType)
+enum class ESimpleSurfaceEasing : uint8
+{
+	Linear,
+	EaseIn,
+	EaseOut,
+	EaseInOut
+};
+
+/**
+ * An animation of a surface's color and glow, evaluated by the material against the world's time.  Once it's pushed,
+ * the animation plays without any further work on the game or render thread.
+ */
+USTRUCT(BlueprintType)
+struct FSimpleSurfaceAnimation
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	ESimpleSurfaceAnimationMode Mode = ESimpleSurfaceAnimationMode::None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (HideAlphaChannel))
+	FColor TargetColor = FColor::White;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.0f, ClampMax = 10.0f))
+	float TargetGlow = 1.0f;
+
+	/**
+	 * The length of the blend, or of one pulse, in seconds.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.01f))
+	float Duration = 1.0f;
+
+	/**
+	 * The number of pulses to play, or 0 to pulse until stopped.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0, EditCondition = "Mode == ESimpleSurfaceAnimationMode::Pulse", EditConditionHides))
+	int32 NumPulses = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	ESimpleSurfaceEasing Easing = ESimpleSurfaceEasing::EaseInOut;
+
+	/**
+	 * The world time, in seconds, at which the animation started.  Set when the animation is played.
+	 */
+	UPROPERTY(BlueprintReadOnly)
+	float StartTime = 0.0f;
+
+	bool IsEnabled() const { return Mode != ESimpleSurfaceAnimationMode::None; }
+
+	/**
+	 * Returns true if the animation is still changing the surface's appearance at the specified world time.
+	 */
+	bool IsPlaying(float WorldTime) const;
+
+	bool operator==(const FSimpleSurfaceAnimation& Other) const = default;
+
+	friend SIMPLESURFACE_API uint32 GetTypeHash(const FSimpleSurfaceAnimation& Animation);
+};
+
+/**
+ * Features of the SimpleSurface material that cost pixel shader time when enabled, even with parameters that make
+ * them invisible.  Material permutations with features switched off statically skip that cost.
+ */
+enum class ESimpleSurfaceFeatures : uint8
+{
+	None = 0,
+	Grid = 1 << 0,
+	Texture = 1 << 1,
+
+	/** Grid aligned to the object rather than the world; only meaningful with Grid. */
+	ObjectAligned = 1 << 2,
+	Glow = 1 << 3,
+
+	/** The features of the default SimpleSurface material. */
+	Default = Grid | Texture | Glow,
+	All = Grid | Texture | ObjectAligned | Glow
+};
+ENUM_CLASS_FLAGS(ESimpleSurfaceFeatures);
+
+/**
+ * The complete set of values pushed to the SimpleSurface material.
+ */
+USTRUCT(BlueprintType)
+struct FSimpleSurfaceParameters
+{
+	GENERATED_BODY()
+
+	FSimpleSurfaceParameters() = default;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (HideAlphaChannel))
+	FColor Color = FColor::FromHex("D84DC2");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=0.0f, ClampMax=10.0f))
+	float Glow = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=0.0f, ClampMax=1.0f))
+	float ShininessRoughness = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=0.0f, ClampMax=1.0f))
+	float WaxinessMetalness = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=0.0f, ClampMax=1.0f))
+	float TextureIntensity = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin=0.0f, ClampMax=1.0f))
+	float TextureScale = 1.0f;
+
+	/**
+	 * The loaded texture override, or null to use the built-in texture.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TObjectPtr<UTexture> Texture;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = -1.0f, ClampMax = 1.0f))
+	float ShowGrid = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FSimpleSurfaceGridParams GridParams;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FSimpleSurfaceAnimation Animation;
+
+	/**
+	 * Returns the material features these parameters make visible.
+	 */
+	ESimpleSurfaceFeatures GetFeatures() const;
+
+	bool operator==(const FSimpleSurfaceParameters& Other) const = default;
+
+	friend SIMPLESURFACE_API uint32 GetTypeHash(const FSimpleSurfaceParameters& Parameters);
+};
+
+/**
+ * Where per-instance variation of an instanced mesh's surface comes from.
+ */
+UENUM(BlueprintType)
+enum class ESimpleSurfaceVariationSource : uint8
+{
+	/** Every instance gets the same surface. */
+	None,
+
+	/** Each instance's color, roughness and grid size are jittered around the surface's, driven by a seed. */
+	Seeded,
+
+	/** Each instance picks its color from a palette, driven by a seed; roughness and grid size are jittered as with Seeded. */
+	Palette,
+
+	/** Each instance's color, roughness and grid size are taken from arrays indexed by instance. */
+	Explicit
+};
+
+/**
+ * Describes how the surface varies across the instances of an instanced static mesh.
+ * Variation is written to per-instance custom data, so all instances still render in one draw call.
+ */
+USTRUCT(BlueprintType)
+struct FSimpleSurfaceInstanceVariation
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	ESimpleSurfaceVariationSource Source = ESimpleSurfaceVariationSource::None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Source == ESimpleSurfaceVariationSource::Seeded || Source == ESimpleSurfaceVariationSource::Palette", EditConditionHides))
+	int32 Seed = 0;
+
+	/**
+	 * The largest hue shift, in degrees, applied to an instance's color.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.0f, ClampMax = 180.0f, EditCondition = "Source == ESimpleSurfaceVariationSource::Seeded", EditConditionHides))
+	float HueVariation = 20.0f;
+
+	/**
+	 * The largest relative change applied to an instance's brightness.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.0f, ClampMax = 1.0f, EditCondition = "Source == ESimpleSurfaceVariationSource::Seeded", EditConditionHides))
+	float BrightnessVariation = 0.2f;
+
+	/**
+	 * The largest change applied to an instance's shininess / roughness.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.0f, ClampMax = 1.0f, EditCondition = "Source == ESimpleSurfaceVariationSource::Seeded || Source == ESimpleSurfaceVariationSource::Palette", EditConditionHides))
+	float RoughnessVariation = 0.1f;
+
+	/**
+	 * The largest relative change applied to an instance's grid size.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.0f, ClampMax = 1.0f, EditCondition = "Source == ESimpleSurfaceVariationSource::Seeded || Source == ESimpleSurfaceVariationSource::Palette", EditConditionHides))
+	float GridSizeVariation = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (HideAlphaChannel, EditCondition = "Source == ESimpleSurfaceVariationSource::Palette", EditConditionHides))
+	TArray<FColor> Palette;
+
+	/**
+	 * Per-instance colors.  Instances beyond the end of the array use the surface's color.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (HideAlphaChannel, EditCondition = "Source == ESimpleSurfaceVariationSource::Explicit", EditConditionHides))
+	TArray<FColor> InstanceColors;
+
+	/**
+	 * Per-instance shininess / roughness.  Instances beyond the end of the array use the surface's value.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Source == ESimpleSurfaceVariationSource::Explicit", EditConditionHides))
+	TArray<float> InstanceRoughness;
+
+	/**
+	 * Per-instance grid sizes.  Instances beyond the end of the array use the surface's grid size.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Source == ESimpleSurfaceVariationSource::Explicit", EditConditionHides))
+	TArray<float> InstanceGridSizes;
+
+	bool IsEnabled() const { return Source != ESimpleSurfaceVariationSource::None; }
+
+	/**
+	 * Returns the parameters of the specified instance, given the surface's parameters.
+	 */
+	SIMPLESURFACE_API FSimpleSurfaceParameters Vary(const FSimpleSurfaceParameters& Base, int32 InstanceIndex) const;
+};
@@ -0,0 +1,286 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceBakeCommandlet.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Level.h"
+#include "Engine/Texture.h"
+#include "Engine/World.h"
+#include "FileHelpers.h"
+#include "GameFramework/Actor.h"
+#include "Hash/CityHash.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSimpleSurfaceBake, Log, All);
+
+namespace SimpleSurfaceBake
+{
+	using namespace SimpleSurfaceParameterNames;
+
+	/**
+	 * Returns a name for the surface's asset that's the same in every session, so re-baking reuses existing assets.
+	 * Values are written with enough digits to tell any two floats apart.  Different surfaces may still share a name;
+	 * @see Matches
+	 */
+	FString GetAssetName(const UMaterialInterface& Parent, const FSimpleSurfaceParameters& Parameters)
+	{
+		const FString Description = FString::Printf(TEXT("%s|%s|%.9g|%.9g|%.9g|%.9g|%.9g|%s|%.9g|%.9g|%.9g|%d"),
+			*Parent.GetPathName(), *Parameters.Color.ToHex(), Parameters.Glow, Parameters.ShininessRoughness,
+			Parameters.WaxinessMetalness, Parameters.TextureIntensity, Parameters.TextureScale,
+			Parameters.Texture ? *Parameters.Texture->GetPathName() : TEXT("None"), Parameters.ShowGrid,
+			Parameters.GridParams.GridSize, Parameters.GridParams.SubGridDivisions, Parameters.GridParams.bIsObjectAligned ? 1 : 0);
+		return FString::Printf(TEXT("MI_SimpleSurface_%016llX"), CityHash64(reinterpret_cast<const char*>(*Description), Description.Len() * sizeof(TCHAR)));
+	}
+
+	/**
+	 * Sets the material's parent and parameter overrides to bake the surface, replacing any it had.
+	 */
+	void Author(UMaterialInstanceConstant& Material, UMaterialInterface& Parent, const FSimpleSurfaceParameters& Parameters)
+	{
+		Material.ClearParameterValuesEditorOnly();
+		Material.SetParentEditorOnly(&Parent);
+
+		Material.SetVectorParameterValueEditorOnly(FMaterialParameterInfo(Color), FLinearColor(Parameters.Color));
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(Glow), Parameters.Glow);
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(WaxinessMetalness), Parameters.WaxinessMetalness);
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(ShininessRoughness), Parameters.ShininessRoughness);
+		if (Parameters.Texture)
+		{
+			Material.SetTextureParameterValueEditorOnly(FMaterialParameterInfo(Texture), Parameters.Texture);
+		}
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(TextureIntensity), Parameters.TextureIntensity);
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(TextureScale), Parameters.TextureScale);
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(ShowGrid), Parameters.ShowGrid);
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(GridSize), Parameters.GridParams.GridSize);
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(SubGridNumber), Parameters.GridParams.SubGridDivisions);
+		Material.SetScalarParameterValueEditorOnly(FMaterialParameterInfo(ObjectAligned), Parameters.GridParams.bIsObjectAligned ? 1.0f : 0.0f);
+		Material.PostEditChange();
+	}
+
+	/**
+	 * Returns true if the material bakes the surface as @see Author would, e.g. so an asset baked by an earlier run is
+	 * only reused if nobody edited it since and no other surface's asset has its name.
+	 */
+	bool Matches(const UMaterialInstanceConstant& Material, const UMaterialInterface& Parent, const FSimpleSurfaceParameters& Parameters)
+	{
+		auto ScalarMatches = [&Material](const FName Name, const float Value)
+		{
+			const auto Found = Material.ScalarParameterValues.FindByPredicate([Name](const auto& Param) { return Param.ParameterInfo.Name == Name; });
+			return Found && Found->ParameterValue == Value;
+		};
+
+		const auto FoundColor = Material.VectorParameterValues.FindByPredicate([](const auto& Param) { return Param.ParameterInfo.Name == Color; });
+		const auto FoundTexture = Material.TextureParameterValues.FindByPredicate([](const auto& Param) { return Param.ParameterInfo.Name == Texture; });
+
+		return Material.Parent == &Parent
+			&& FoundColor && FoundColor->ParameterValue == FLinearColor(Parameters.Color)
+			&& (FoundTexture ? FoundTexture->ParameterValue == Parameters.Texture : !Parameters.Texture)
+			&& ScalarMatches(Glow, Parameters.Glow)
+			&& ScalarMatches(WaxinessMetalness, Parameters.WaxinessMetalness)
+			&& ScalarMatches(ShininessRoughness, Parameters.ShininessRoughness)
+			&& ScalarMatches(TextureIntensity, Parameters.TextureIntensity)
+			&& ScalarMatches(TextureScale, Parameters.TextureScale)
+			&& ScalarMatches(ShowGrid, Parameters.ShowGrid)
+			&& ScalarMatches(GridSize, Parameters.GridParams.GridSize)
+			&& ScalarMatches(SubGridNumber, Parameters.GridParams.SubGridDivisions)
+			&& ScalarMatches(ObjectAligned, Parameters.GridParams.bIsObjectAligned ? 1.0f : 0.0f);
+	}
+}
+
+USimpleSurfaceBakeCommandlet::USimpleSurfaceBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 USimpleSurfaceBakeCommandlet::Main(const FString& Params)
+{
+	OutputPath = TEXT("/Game/SimpleSurface/Baked");
+	FParse::Value(*Params, TEXT("OutputPath="), OutputPath);
+
+	TArray<FString> MapNames;
+	FString MapsParam;
+	if (FParse::Value(*Params, TEXT("Maps="), MapsParam))
+	{
+		MapsParam.ParseIntoArray(MapNames, TEXT("+"));
+	}
+	else
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		AssetRegistry.SearchAllAssets(/*bSynchronousSearch=*/true);
+
+		TArray<FAssetData> Maps;
+		AssetRegistry.GetAssetsByPath(TEXT("/Game"), Maps, /*bRecursive=*/true);
+		for (const auto& Map : Maps)
+		{
+			if (Map.AssetClassPath == UWorld::StaticClass()->GetClassPathName())
+			{
+				MapNames.Add(Map.PackageName.ToString());
+			}
+		}
+	}
+
+	int32 NumBaked = 0;
+	int32 NumSkipped = 0;
+	int32 NumFailedMaps = 0;
+
+	for (const auto& MapName : MapNames)
+	{
+		UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+		UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+		if (!World)
+		{
+			UE_LOG(LogSimpleSurfaceBake, Error, TEXT("Couldn't load map %s"), *MapName);
+			++NumFailedMaps;
+			continue;
+		}
+
+		// Only actors loaded with the map are visited below, which leaves out every actor World Partition streams.
+		if (World->IsPartitionedWorld())
+		{
+			UE_LOG(LogSimpleSurfaceBake, Error, TEXT("Couldn't bake %s, which uses World Partition; its actors aren't loaded with the map"), *MapName);
+			++NumFailedMaps;
+			continue;
+		}
+
+		UE_LOG(LogSimpleSurfaceBake, Display, TEXT("Baking %s..."), *MapName);
+
+		for (const auto Level : World->GetLevels())
+		{
+			for (const auto Actor : Level->Actors)
+			{
+				if (!Actor)
+				{
+					continue;
+				}
+
+				TInlineComponentArray<USimpleSurfaceComponent*> SurfaceComponents(Actor);
+				for (const auto Component : SurfaceComponents)
+				{
+					if (!Component->CanBake())
+					{
+						UE_LOG(LogSimpleSurfaceBake, Display, TEXT("  Skipping %s, which %s"), *Component->GetPathName(),
+							Component->Animation.IsEnabled() ? TEXT("is animated") : TEXT("varies across instances"));
+						++NumSkipped;
+						continue;
+					}
+
+					if (Component->HasCurrentBake())
+					{
+						continue;
+					}
+
+					UMaterialInstanceConstant* BakedMaterial = FindOrCreateBakedMaterial(*Component);
+					if (!BakedMaterial)
+					{
+						++NumSkipped;
+						continue;
+					}
+
+					Component->Modify();
+					Component->BakedMaterial = BakedMaterial;
+					Component->BakedParameters = Component->GetSurfaceParameters();
+
+					// Actors saved in their own package (one file per actor) must be saved there.
+					PackagesToSave.AddUnique(Component->GetPackage());
+					++NumBaked;
+				}
+			}
+		}
+	}
+
+	if (!PackagesToSave.IsEmpty() && !UEditorLoadingAndSavingUtils::SavePackages(PackagesToSave, /*bOnlyDirty=*/false))
+	{
+		UE_LOG(LogSimpleSurfaceBake, Error, TEXT("Couldn't save all baked packages"));
+		return 1;
+	}
+
+	UE_LOG(LogSimpleSurfaceBake, Display, TEXT("Baked %d surfaces into %d materials; skipped %d."), NumBaked, BakedMaterials.Num(), NumSkipped);
+	if (NumFailedMaps > 0)
+	{
+		UE_LOG(LogSimpleSurfaceBake, Error, TEXT("%d of %d maps couldn't be baked"), NumFailedMaps, MapNames.Num());
+		return 1;
+	}
+	return 0;
+}
+
+UMaterialInstanceConstant* USimpleSurfaceBakeCommandlet::FindOrCreateBakedMaterial(const USimpleSurfaceComponent& Component)
+{
+	UMaterialInterface* Parent = Component.GetParentMaterial();
+	if (!Parent)
+	{
+		UE_LOG(LogSimpleSurfaceBake, Warning, TEXT("  Skipping %s, which has no base material"), *Component.GetPathName());
+		return nullptr;
+	}
+
+	// Texture overrides are streamed in by the surface's world, which the bake doesn't wait for.
+	Component.GetTextureOverride().LoadSynchronous();
+
+	FSimpleSurfaceMaterialKey Key;
+	Key.Parent = Parent;
+	Key.Parameters = Component.GetSurfaceParameters();
+	if (const auto Found = BakedMaterials.Find(Key))
+	{
+		return *Found;
+	}
+
+	// Assets baked by an earlier run are reused as long as they still bake this surface.  One baked for another surface
+	// in this run keeps its values; this surface moves on to the next name.
+	const FString BaseAssetName = SimpleSurfaceBake::GetAssetName(*Parent, Key.Parameters);
+	FString AssetName = BaseAssetName;
+	UMaterialInstanceConstant* Material = nullptr;
+	for (int32 Attempt = 1; ; ++Attempt)
+	{
+		const FString PackageName = OutputPath / AssetName;
+		Material = LoadObject<UMaterialInstanceConstant>(nullptr, *(PackageName + TEXT(".") + AssetName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+		if (!Material)
+		{
+			UPackage* Package = CreatePackage(*PackageName);
+			Material = NewObject<UMaterialInstanceConstant>(Package, *AssetName, RF_Public | RF_Standalone);
+			SimpleSurfaceBake::Author(*Material, *Parent, Key.Parameters);
+
+			FAssetRegistryModule::AssetCreated(Material);
+			Package->MarkPackageDirty();
+			PackagesToSave.Add(Package);
+
+			UE_LOG(LogSimpleSurfaceBake, Display, TEXT("  Created %s"), *PackageName);
+			break;
+		}
+
+		if (SimpleSurfaceBake::Matches(*Material, *Parent, Key.Parameters))
+		{
+			break;
+		}
+
+		if (!BakedMaterials.FindKey(Material))
+		{
+			SimpleSurfaceBake::Author(*Material, *Parent, Key.Parameters);
+			Material->MarkPackageDirty();
+			PackagesToSave.AddUnique(Material->GetPackage());
+
+			UE_LOG(LogSimpleSurfaceBake, Display, TEXT("  Updated %s, whose values no longer matched"), *PackageName);
+			break;
+		}
+
+		AssetName = FString::Printf(TEXT("%s_%d"), *BaseAssetName, Attempt);
+	}
+
+	BakedMaterials.Add(Key, Material);
+	return Material;
+}
@@ -0,0 +1,292 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceBenchmarkCommandlet.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "SimpleSurfaceSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformTime.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSimpleSurfaceBenchmark, Log, All);
+
+namespace SimpleSurfaceBenchmark
+{
+	TArray<int32> ParseCounts(const FString& Params, const TCHAR* Name, const TArray<int32>& Default)
+	{
+		FString Value;
+		if (!FParse::Value(*Params, Name, Value, /*bShouldStopOnSeparator=*/false))
+		{
+			return Default;
+		}
+
+		TArray<FString> Tokens;
+		Value.ParseIntoArray(Tokens, TEXT(","));
+
+		TArray<int32> Counts;
+		for (const auto& Token : Tokens)
+		{
+			const int32 Count = FCString::Atoi(*Token);
+			if (Count > 0)
+			{
+				Counts.Add(Count);
+			}
+		}
+		return Counts.IsEmpty() ? Default : Counts;
+	}
+
+	/**
+	 * Runs Function once per component and returns the total time it took, in milliseconds.
+	 */
+	template <typename FunctionType>
+	double TimeForEach(const TArray<USimpleSurfaceComponent*>& Components, FunctionType Function)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (const auto Component : Components)
+		{
+			Function(*Component);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	}
+}
+
+USimpleSurfaceBenchmarkCommandlet::USimpleSurfaceBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 USimpleSurfaceBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace SimpleSurfaceBenchmark;
+
+	const auto ActorCounts = ParseCounts(Params, TEXT("Actors="), { 100, 1000 });
+	const auto MeshComponentCounts = ParseCounts(Params, TEXT("MeshComponents="), { 1, 4 });
+	const auto SlotCounts = ParseCounts(Params, TEXT("Slots="), { 1, 4 });
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Duplicates="), NumDuplicates);
+
+	FString Value;
+	if (FParse::Value(*Params, TEXT("ChangeDetection="), Value))
+	{
+		ChangeDetection = Value == TEXT("EventDriven") ? ESimpleSurfaceChangeDetection::EventDriven : ESimpleSurfaceChangeDetection::Polling;
+	}
+	if (FParse::Value(*Params, TEXT("RenderMode="), Value))
+	{
+		RenderMode = Value == TEXT("CustomPrimitiveData") ? ESimpleSurfaceRenderMode::CustomPrimitiveData : ESimpleSurfaceRenderMode::MaterialInstance;
+	}
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("SimpleSurfaceBenchmark") / FDateTime::Now().ToString();
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	TArray<FResult> Results;
+	for (const int32 NumActors : ActorCounts)
+	{
+		for (const int32 NumMeshComponents : MeshComponentCounts)
+		{
+			for (const int32 NumSlots : SlotCounts)
+			{
+				const FScenario Scenario { NumActors, NumMeshComponents, NumSlots };
+				UE_LOG(LogSimpleSurfaceBenchmark, Display, TEXT("Measuring %d actors with %d mesh components of %d slots each..."), NumActors, NumMeshComponents, NumSlots);
+
+				const auto& Result = Results.Add_GetRef(RunScenario(Scenario));
+				UE_LOG(LogSimpleSurfaceBenchmark, Display, TEXT("  spawn %.2f ms, tick %.3f ms/frame, ApplyAll %.2f ms, UpdateMeshCatalog %.2f ms, TryRestoreMaterials %.2f ms, %lld bytes/component"),
+					Result.SpawnMs, Result.TickMsPerFrame, Result.ApplyAllMs, Result.UpdateMeshCatalogMs, Result.TryRestoreMaterialsMs, Result.BytesPerComponent);
+			}
+		}
+	}
+
+	WriteResults(Results, OutputPath);
+	return 0;
+}
+
+USimpleSurfaceBenchmarkCommandlet::FResult USimpleSurfaceBenchmarkCommandlet::RunScenario(const FScenario& Scenario) const
+{
+	using namespace SimpleSurfaceBenchmark;
+
+	FResult Result;
+	Result.Scenario = Scenario;
+
+	// Editor worlds register tick functions without having to begin play.
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, /*bInformEngineOfWorld=*/false, TEXT("SimpleSurfaceBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	TArray<AActor*> Actors;
+	TArray<USimpleSurfaceComponent*> Components;
+	Actors.Reserve(Scenario.NumActors);
+	Components.Reserve(Scenario.NumActors);
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Scenario.NumActors; ++i)
+	{
+		const auto Actor = SpawnSurfaceActor(*World, Scenario, i);
+		Actors.Add(Actor);
+		Components.Add(Actor->FindComponentByClass<USimpleSurfaceComponent>());
+	}
+	Result.SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Steady state: nothing changes, so this is the cost of noticing that nothing changed.
+	constexpr float DeltaSeconds = 1.0f / 60.0f;
+	const auto Subsystem = World->GetSubsystem<USimpleSurfaceSubsystem>();
+	int64 NumChecks = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+		++GFrameCounter;
+		NumChecks += Subsystem ? Subsystem->GetLastFrameStats().NumChecked : 0;
+	}
+	Result.TickMsPerFrame = (FPlatformTime::Seconds() - StartTime) * 1000.0 / FMath::Max(NumFrames, 1);
+	Result.ChecksPerFrame = static_cast<double>(NumChecks) / FMath::Max(NumFrames, 1);
+
+	Result.ApplyAllMs = TimeForEach(Components, [](USimpleSurfaceComponent& Component) { Component.ApplyAll(); });
+	Result.UpdateMeshCatalogMs = TimeForEach(Components, [](USimpleSurfaceComponent& Component) { Component.UpdateMeshCatalog(); });
+
+	int64 TotalBytes = 0;
+	for (const auto Component : Components)
+	{
+		FArchiveCountMem CountMem(Component);
+		TotalBytes += CountMem.GetMax();
+	}
+	Result.BytesPerComponent = TotalBytes / FMath::Max(Components.Num(), 1);
+	Result.NumPooledMaterials = Subsystem ? Subsystem->GetNumPooledMaterials() : 0;
+
+	const int32 NumToDuplicate = FMath::Min(NumDuplicates, Actors.Num());
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumToDuplicate; ++i)
+	{
+		// Duplicated like the editor does, so SimpleSurface sees a copy of the original's state on registration.
+		const auto Duplicate = CastChecked<AActor>(StaticDuplicateObject(Actors[i], World->PersistentLevel));
+		World->PersistentLevel->Actors.Add(Duplicate);
+		Duplicate->RegisterAllComponents();
+	}
+	Result.DuplicateMsPerActor = NumToDuplicate > 0 ? (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumToDuplicate : 0.0;
+
+	Result.TryRestoreMaterialsMs = TimeForEach(Components, [](USimpleSurfaceComponent& Component) { Component.RestoreImmediately(); });
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(/*bInformEngineOfWorld=*/false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	return Result;
+}
+
+AActor* USimpleSurfaceBenchmarkCommandlet::SpawnSurfaceActor(UWorld& World, const FScenario& Scenario, const int32 Index) const
+{
+	static UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	static UMaterialInterface* Material = LoadObject<UMaterialInterface>(nullptr, TEXT("/Engine/BasicShapes/BasicShapeMaterial.BasicShapeMaterial"));
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.bDeferConstruction = true;
+	const auto Actor = World.SpawnActor<AActor>(AActor::StaticClass(), FTransform(FVector(Index * 200.0, 0.0, 0.0)), SpawnParameters);
+
+	for (int32 i = 0; i < Scenario.NumMeshComponents; ++i)
+	{
+		const auto MeshComponent = NewObject<UStaticMeshComponent>(Actor);
+		MeshComponent->SetStaticMesh(Mesh);
+
+		// A static mesh component has as many slots as it has override materials, if that's more than its mesh has.
+		for (int32 Slot = 0; Slot < Scenario.NumSlots; ++Slot)
+		{
+			MeshComponent->SetMaterial(Slot, Material);
+		}
+
+		if (i == 0)
+		{
+			Actor->SetRootComponent(MeshComponent);
+		}
+		else
+		{
+			MeshComponent->SetupAttachment(Actor->GetRootComponent());
+		}
+		Actor->AddInstanceComponent(MeshComponent);
+		MeshComponent->RegisterComponent();
+	}
+
+	const auto SurfaceComponent = NewObject<USimpleSurfaceComponent>(Actor);
+	SurfaceComponent->ChangeDetection = ChangeDetection;
+	SurfaceComponent->RenderMode = RenderMode;
+
+	// Give every actor a different color, so pooled materials aren't all shared by one surface.
+	SurfaceComponent->Color = FLinearColor::MakeFromHSV8(static_cast<uint8>(Index * 37), 200, 220).ToFColor(true);
+
+	Actor->AddInstanceComponent(SurfaceComponent);
+	SurfaceComponent->RegisterComponent();
+
+	Actor->FinishSpawning(FTransform(FVector(Index * 200.0, 0.0, 0.0)));
+	return Actor;
+}
+
+void USimpleSurfaceBenchmarkCommandlet::WriteResults(const TArray<FResult>& Results, const FString& OutputPath) const
+{
+	FString Csv = TEXT("Actors,MeshComponents,Slots,SpawnMs,TickMsPerFrame,ChecksPerFrame,ApplyAllMs,UpdateMeshCatalogMs,TryRestoreMaterialsMs,DuplicateMsPerActor,BytesPerComponent,PooledMaterials\n");
+	TArray<TSharedPtr<FJsonValue>> JsonResults;
+
+	for (const auto& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%d,%d,%d,%.3f,%.4f,%.1f,%.3f,%.3f,%.3f,%.4f,%lld,%d\n"),
+			Result.Scenario.NumActors, Result.Scenario.NumMeshComponents, Result.Scenario.NumSlots,
+			Result.SpawnMs, Result.TickMsPerFrame, Result.ChecksPerFrame, Result.ApplyAllMs, Result.UpdateMeshCatalogMs,
+			Result.TryRestoreMaterialsMs, Result.DuplicateMsPerActor, Result.BytesPerComponent, Result.NumPooledMaterials);
+
+		const auto JsonResult = MakeShared<FJsonObject>();
+		JsonResult->SetNumberField(TEXT("Actors"), Result.Scenario.NumActors);
+		JsonResult->SetNumberField(TEXT("MeshComponents"), Result.Scenario.NumMeshComponents);
+		JsonResult->SetNumberField(TEXT("Slots"), Result.Scenario.NumSlots);
+		JsonResult->SetNumberField(TEXT("SpawnMs"), Result.SpawnMs);
+		JsonResult->SetNumberField(TEXT("TickMsPerFrame"), Result.TickMsPerFrame);
+		JsonResult->SetNumberField(TEXT("ChecksPerFrame"), Result.ChecksPerFrame);
+		JsonResult->SetNumberField(TEXT("ApplyAllMs"), Result.ApplyAllMs);
+		JsonResult->SetNumberField(TEXT("UpdateMeshCatalogMs"), Result.UpdateMeshCatalogMs);
+		JsonResult->SetNumberField(TEXT("TryRestoreMaterialsMs"), Result.TryRestoreMaterialsMs);
+		JsonResult->SetNumberField(TEXT("DuplicateMsPerActor"), Result.DuplicateMsPerActor);
+		JsonResult->SetNumberField(TEXT("BytesPerComponent"), Result.BytesPerComponent);
+		JsonResult->SetNumberField(TEXT("PooledMaterials"), Result.NumPooledMaterials);
+		JsonResults.Add(MakeShared<FJsonValueObject>(JsonResult));
+	}
+
+	const auto Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("ChangeDetection"), StaticEnum<ESimpleSurfaceChangeDetection>()->GetNameStringByValue(static_cast<int64>(ChangeDetection)));
+	Json->SetStringField(TEXT("RenderMode"), StaticEnum<ESimpleSurfaceRenderMode>()->GetNameStringByValue(static_cast<int64>(RenderMode)));
+	Json->SetNumberField(TEXT("Frames"), NumFrames);
+	Json->SetArrayField(TEXT("Results"), JsonResults);
+
+	FString JsonText;
+	const auto Writer = TJsonWriterFactory<>::Create(&JsonText);
+	FJsonSerializer::Serialize(Json, Writer);
+
+	const FString CsvPath = OutputPath + TEXT(".csv");
+	const FString JsonPath = OutputPath + TEXT(".json");
+	if (FFileHelper::SaveStringToFile(Csv, *CsvPath) && FFileHelper::SaveStringToFile(JsonText, *JsonPath))
+	{
+		UE_LOG(LogSimpleSurfaceBenchmark, Display, TEXT("Wrote %s and %s"), *CsvPath, *JsonPath);
+	}
+	else
+	{
+		UE_LOG(LogSimpleSurfaceBenchmark, Error, TEXT("Couldn't write results to %s"), *OutputPath);
+	}
+}
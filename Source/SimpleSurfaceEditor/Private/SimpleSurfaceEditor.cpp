@@ -0,0 +1,40 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#include "SimpleSurfaceEditor.h"
+
+#include "SimpleSurfaceEditorLibrary.h"
+#include "ToolMenus.h"
+
+#define LOCTEXT_NAMESPACE "FSimpleSurfaceEditorModule"
+
+void FSimpleSurfaceEditorModule::StartupModule()
+{
+	UToolMenus::RegisterStartupCallback(FSimpleMulticastDelegate::FDelegate::CreateRaw(this, &FSimpleSurfaceEditorModule::RegisterMenus));
+}
+
+void FSimpleSurfaceEditorModule::ShutdownModule()
+{
+	UToolMenus::UnRegisterStartupCallback(this);
+	UToolMenus::UnregisterOwner(this);
+}
+
+void FSimpleSurfaceEditorModule::RegisterMenus()
+{
+	FToolMenuOwnerScoped OwnerScoped(this);
+	USimpleSurfaceEditorLibrary::RegisterMenus();
+}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FSimpleSurfaceEditorModule, SimpleSurfaceEditor)
\ No newline at end of file
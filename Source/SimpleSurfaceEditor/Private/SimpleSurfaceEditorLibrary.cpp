@@ -0,0 +1,223 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+
+#include "SimpleSurfaceEditorLibrary.h"
+
+#include "SimpleSurfaceComponent.h"
+#include "SimpleSurfaceMeshIdentity.h"
+#include "SimpleSurfaceSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Components/MeshComponent.h"
+#include "Editor.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Selection.h"
+#include "GameFramework/Actor.h"
+#include "ScopedTransaction.h"
+#include "ToolMenus.h"
+
+#define LOCTEXT_NAMESPACE "SimpleSurfaceEditorLibrary"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSimpleSurfaceEditor, Log, All);
+
+namespace SimpleSurfaceEditor
+{
+	TArray<AActor*> GetSelectedActors()
+	{
+		TArray<AActor*> Actors;
+		if (GEditor)
+		{
+			GEditor->GetSelectedActors()->GetSelectedObjects<AActor>(Actors);
+		}
+		return Actors;
+	}
+}
+
+int32 USimpleSurfaceEditorLibrary::AddSimpleSurface(const TArray<AActor*>& Actors, USimpleSurfacePreset* Preset)
+{
+	struct FPendingSurface
+	{
+		AActor* Actor = nullptr;
+		TArray<UMeshComponent*, TInlineAllocator<8>> MeshComponents;
+		FSimpleSurfaceMeshCatalog MeshCatalog;
+		bool bCaptureInParallel = true;
+	};
+
+	TArray<FPendingSurface> PendingSurfaces;
+	PendingSurfaces.Reserve(Actors.Num());
+	for (const auto Actor : Actors)
+	{
+		if (!IsValid(Actor) || Actor->FindComponentByClass<USimpleSurfaceComponent>())
+		{
+			continue;
+		}
+
+		auto& Pending = PendingSurfaces.AddDefaulted_GetRef();
+		Pending.Actor = Actor;
+		Actor->GetComponents<UMeshComponent>(Pending.MeshComponents);
+		if (Pending.MeshComponents.IsEmpty())
+		{
+			PendingSurfaces.Pop(EAllowShrinking::No);
+			continue;
+		}
+
+		for (const auto MeshComponent : Pending.MeshComponents)
+		{
+			Pending.bCaptureInParallel &= FSimpleSurfaceMeshIdentity::Get().IsThreadSafe(*MeshComponent);
+		}
+	}
+
+	if (PendingSurfaces.IsEmpty())
+	{
+		return 0;
+	}
+
+	// Capturing only reads the mesh components; registering then finds each catalog complete and only assigns materials.
+	const TArray<const UMaterialInterface*> ExcludedMaterials = { USimpleSurfaceSubsystem::GetCustomDataMaterial() };
+	ParallelFor(PendingSurfaces.Num(), [&PendingSurfaces, &ExcludedMaterials](const int32 Index)
+	{
+		auto& Pending = PendingSurfaces[Index];
+		if (Pending.bCaptureInParallel)
+		{
+			Pending.MeshCatalog.Capture(Pending.MeshComponents, ExcludedMaterials);
+		}
+	});
+
+	const FScopedTransaction Transaction(FText::Format(LOCTEXT("AddSimpleSurface", "Add SimpleSurface to {0} Actors"), PendingSurfaces.Num()));
+	for (auto& Pending : PendingSurfaces)
+	{
+		if (!Pending.bCaptureInParallel)
+		{
+			Pending.MeshCatalog.Capture(Pending.MeshComponents, ExcludedMaterials);
+		}
+
+		AActor* Actor = Pending.Actor;
+		Actor->Modify();
+
+		const FName ComponentName = MakeUniqueObjectName(Actor, USimpleSurfaceComponent::StaticClass(), TEXT("SimpleSurface"));
+		const auto SurfaceComponent = NewObject<USimpleSurfaceComponent>(Actor, ComponentName, RF_Transactional);
+		SurfaceComponent->Preset = Preset;
+		SurfaceComponent->InitializeFromCapturedCatalog(MoveTemp(Pending.MeshCatalog), Pending.MeshComponents.Num());
+
+		// Surfaces with identical parameters acquire the same pooled material instance as they register.
+		Actor->AddInstanceComponent(SurfaceComponent);
+		SurfaceComponent->RegisterComponent();
+	}
+
+	UE_LOG(LogSimpleSurfaceEditor, Log, TEXT("Added SimpleSurface to %d of %d actors."), PendingSurfaces.Num(), Actors.Num())
+	return PendingSurfaces.Num();
+}
+
+int32 USimpleSurfaceEditorLibrary::RemoveSimpleSurface(const TArray<AActor*>& Actors)
+{
+	TArray<USimpleSurfaceComponent*> SurfaceComponents;
+	int32 NumClassComponents = 0;
+	for (const auto Actor : Actors)
+	{
+		if (!IsValid(Actor))
+		{
+			continue;
+		}
+
+		TArray<USimpleSurfaceComponent*, TInlineAllocator<1>> ActorSurfaceComponents;
+		Actor->GetComponents<USimpleSurfaceComponent>(ActorSurfaceComponents);
+		for (const auto SurfaceComponent : ActorSurfaceComponents)
+		{
+			if (SurfaceComponent->CreationMethod == EComponentCreationMethod::Instance)
+			{
+				SurfaceComponents.Add(SurfaceComponent);
+			}
+			else
+			{
+				++NumClassComponents;
+			}
+		}
+	}
+
+	if (NumClassComponents > 0)
+	{
+		UE_LOG(LogSimpleSurfaceEditor, Warning, TEXT("Skipped %d SimpleSurfaceComponents that are part of their actor's class."), NumClassComponents)
+	}
+
+	if (SurfaceComponents.IsEmpty())
+	{
+		return 0;
+	}
+
+	// Load every original material in one batch, rather than once for every component as it's destroyed.
+	TSet<FSoftObjectPath> UnloadedMaterials;
+	TArray<FSoftObjectPath> ComponentUnloadedMaterials;
+	for (const auto SurfaceComponent : SurfaceComponents)
+	{
+		ComponentUnloadedMaterials.Reset();
+		SurfaceComponent->GetMeshCatalog().CollectUnloadedMaterials(ComponentUnloadedMaterials);
+		UnloadedMaterials.Append(ComponentUnloadedMaterials);
+	}
+
+	TSharedPtr<FStreamableHandle> Handle;
+	if (!UnloadedMaterials.IsEmpty())
+	{
+		Handle = UAssetManager::GetStreamableManager().RequestSyncLoad(UnloadedMaterials.Array());
+	}
+
+	{
+		const FScopedTransaction Transaction(FText::Format(LOCTEXT("RemoveSimpleSurface", "Remove SimpleSurface from {0} Actors"), SurfaceComponents.Num()));
+		for (const auto SurfaceComponent : SurfaceComponents)
+		{
+			AActor* Actor = SurfaceComponent->GetOwner();
+			Actor->Modify();
+			SurfaceComponent->Modify();
+
+			// Restore within the transaction, rather than leaving it to the end of the frame.
+			SurfaceComponent->RestoreImmediately();
+			Actor->RemoveInstanceComponent(SurfaceComponent);
+			SurfaceComponent->DestroyComponent();
+		}
+	}
+
+	if (Handle.IsValid())
+	{
+		Handle->ReleaseHandle();
+	}
+
+	UE_LOG(LogSimpleSurfaceEditor, Log, TEXT("Removed %d SimpleSurfaceComponents."), SurfaceComponents.Num())
+	return SurfaceComponents.Num();
+}
+
+void USimpleSurfaceEditorLibrary::RegisterMenus()
+{
+	UToolMenu* Menu = UToolMenus::Get()->ExtendMenu("LevelEditor.ActorContextMenu");
+	FToolMenuSection& Section = Menu->FindOrAddSection("SimpleSurface", LOCTEXT("SimpleSurfaceSection", "Simple Surface"));
+
+	Section.AddMenuEntry(
+		"AddSimpleSurface",
+		LOCTEXT("AddSimpleSurfaceLabel", "Add SimpleSurface"),
+		LOCTEXT("AddSimpleSurfaceTooltip", "Adds a SimpleSurfaceComponent to every selected actor that has meshes and none yet."),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateLambda([]
+		{
+			AddSimpleSurface(SimpleSurfaceEditor::GetSelectedActors());
+		})));
+
+	Section.AddMenuEntry(
+		"RemoveSimpleSurface",
+		LOCTEXT("RemoveSimpleSurfaceLabel", "Remove SimpleSurface"),
+		LOCTEXT("RemoveSimpleSurfaceTooltip", "Removes SimpleSurfaceComponents from every selected actor, restoring their original materials."),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateLambda([]
+		{
+			RemoveSimpleSurface(SimpleSurfaceEditor::GetSelectedActors());
+		})));
+}
+
+#undef LOCTEXT_NAMESPACE
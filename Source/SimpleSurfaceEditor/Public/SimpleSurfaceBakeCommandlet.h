@@ -0,0 +1,59 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SimpleSurfaceSubsystem.h"
+
+#include "SimpleSurfaceBakeCommandlet.generated.h"
+
+class UMaterialInstanceConstant;
+class USimpleSurfaceComponent;
+
+/**
+ * Bakes every SimpleSurfaceComponent in the specified maps into a material instance asset, so cooked builds need no
+ * dynamic material instances, ticking or catalog data.  Components with identical surfaces share one asset.
+ *
+ *     UnrealEditor-Cmd <Project> -run=SimpleSurfaceBake [-Maps=/Game/Maps/A+/Game/Maps/B] [-OutputPath=/Game/SimpleSurface/Baked]
+ *
+ * Without -Maps, every map under /Game is baked.  The assets are assigned to each component's BakedMaterial; when
+ * cooking, components with a current bake assign it to their actor's meshes and are left out of the cooked package.
+ * Surfaces that vary across instances can't be baked and are skipped.
+ *
+ * Maps using World Partition aren't supported yet, since their actors aren't loaded with the map.  They're reported as
+ * errors, and the commandlet fails, rather than being baked partially.
+ */
+UCLASS()
+class USimpleSurfaceBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USimpleSurfaceBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/**
+	 * Returns the baked material for the component's surface, creating or loading the asset if this run hasn't yet.
+	 */
+	UMaterialInstanceConstant* FindOrCreateBakedMaterial(const USimpleSurfaceComponent& Component);
+
+	FString OutputPath;
+
+	TMap<FSimpleSurfaceMaterialKey, TObjectPtr<UMaterialInstanceConstant>> BakedMaterials;
+
+	TArray<UPackage*> PackagesToSave;
+};
@@ -0,0 +1,91 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "SimpleSurfaceBenchmarkCommandlet.generated.h"
+
+class UWorld;
+enum class ESimpleSurfaceChangeDetection : uint8;
+enum class ESimpleSurfaceRenderMode : uint8;
+
+/**
+ * Measures SimpleSurface's costs across populations of actors, and writes the results as CSV and JSON so they can be
+ * compared between plugin versions.  Runs headless:
+ *
+ *     UnrealEditor-Cmd <Project> -run=SimpleSurfaceBenchmark -nullrhi -unattended
+ *         [-Actors=100,1000] [-MeshComponents=1,4] [-Slots=1,4] [-Frames=120] [-Duplicates=100]
+ *         [-ChangeDetection=Polling|EventDriven] [-RenderMode=MaterialInstance|CustomPrimitiveData]
+ *         [-Output=<path without extension>]
+ *
+ * Every combination of actor, mesh component and slot counts is measured in a fresh world.
+ */
+UCLASS()
+class USimpleSurfaceBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USimpleSurfaceBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	struct FScenario
+	{
+		int32 NumActors = 0;
+		int32 NumMeshComponents = 0;
+		int32 NumSlots = 0;
+	};
+
+	struct FResult
+	{
+		FScenario Scenario;
+
+		/** Spawning the actors, including SimpleSurface capturing and applying on registration. */
+		double SpawnMs = 0.0;
+
+		/** The average world tick once spawned, and the average number of components the subsystem checked per tick. */
+		double TickMsPerFrame = 0.0;
+		double ChecksPerFrame = 0.0;
+
+		double ApplyAllMs = 0.0;
+		double UpdateMeshCatalogMs = 0.0;
+		double TryRestoreMaterialsMs = 0.0;
+
+		/** Duplicating actors, per duplicate. */
+		double DuplicateMsPerActor = 0.0;
+
+		/** The memory held by each SimpleSurfaceComponent, including its catalog. */
+		int64 BytesPerComponent = 0;
+
+		int32 NumPooledMaterials = 0;
+	};
+
+	FResult RunScenario(const FScenario& Scenario) const;
+
+	/**
+	 * Spawns an actor with the scenario's mesh components and a SimpleSurfaceComponent.
+	 */
+	AActor* SpawnSurfaceActor(UWorld& World, const FScenario& Scenario, int32 Index) const;
+
+	void WriteResults(const TArray<FResult>& Results, const FString& OutputPath) const;
+
+	int32 NumFrames = 120;
+	int32 NumDuplicates = 100;
+	ESimpleSurfaceChangeDetection ChangeDetection = {};
+	ESimpleSurfaceRenderMode RenderMode = {};
+};
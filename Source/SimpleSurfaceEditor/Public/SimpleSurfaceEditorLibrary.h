@@ -0,0 +1,60 @@
+// Copyright 2025, Jeff Stewart
+// Email: object01@gmail.com
+// All rights reserved.
+//
+// This software is provided "as is," without warranty of any kind,
+// express or implied, including but not limited to the warranties
+// of merchantability, fitness for a particular purpose, and
+// noninfringement. In no event shall the author be liable for any
+// claim, damages, or other liability, whether in an action of
+// contract, tort, or otherwise, arising from, out of, or in
+// connection with the software or the use or other dealings in
+// the software.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+
+#include "SimpleSurfaceEditorLibrary.generated.h"
+
+class AActor;
+class USimpleSurfacePreset;
+
+/**
+ * Adds SimpleSurface to, or removes it from, many actors at once, in one transaction that a single undo reverts.
+ * Available from editor utilities, Python and the level editor's actor context menu:
+ *
+ *     unreal.SimpleSurfaceEditorLibrary.add_simple_surface(unreal.EditorLevelLibrary.get_selected_level_actors())
+ */
+UCLASS()
+class USimpleSurfaceEditorLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Adds a SimpleSurfaceComponent to each actor that has mesh components and no SimpleSurfaceComponent yet.  The
+	 * actors' materials are captured in parallel where that's safe, and surfaces with identical parameters share one
+	 * material instance.
+	 *
+	 * @return The number of actors a SimpleSurfaceComponent was added to.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Simple Surface|Editor")
+	static int32 AddSimpleSurface(const TArray<AActor*>& Actors, USimpleSurfacePreset* Preset = nullptr);
+
+	/**
+	 * Removes the SimpleSurfaceComponents added to the actors' instances, restoring their original materials.  The
+	 * materials all are loaded in one batch first.  Components that are part of an actor's class are left alone.
+	 *
+	 * @return The number of SimpleSurfaceComponents removed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Simple Surface|Editor")
+	static int32 RemoveSimpleSurface(const TArray<AActor*>& Actors);
+
+	/**
+	 * Adds the bulk operations to the level editor's actor context menu, for the selected actors.
+	 */
+	static void RegisterMenus();
+};